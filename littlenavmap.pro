@@ -119,6 +119,7 @@ SOURCES += src/main.cpp\
     src/common/mapcolors.cpp \
     src/mapgui/mappainternav.cpp \
     src/search/navicondelegate.cpp \
+    src/search/searchicondelegate.cpp \
     src/mapgui/mappainterils.cpp \
     src/common/maptools.cpp \
     src/route/routecontroller.cpp \
@@ -137,6 +138,8 @@ SOURCES += src/main.cpp\
     src/route/routenetworkradio.cpp \
     src/route/routenetworkairway.cpp \
     src/route/routenetwork.cpp \
+    src/route/windgrid.cpp \
+    src/route/routebenchmark.cpp \
     src/common/weatherreporter.cpp \
     src/connect/connectdialog.cpp \
     src/connect/connectclient.cpp \
@@ -144,6 +147,7 @@ SOURCES += src/main.cpp\
     src/profile/profilewidget.cpp \
     src/route/routemapobjectlist.cpp \
     src/common/aircrafttrack.cpp \
+    src/common/aitraffic.cpp \
     src/info/infocontroller.cpp \
     src/common/symbolpainter.cpp \
     src/db/databasemanager.cpp \
@@ -162,6 +166,7 @@ SOURCES += src/main.cpp\
     src/print/printsupport.cpp \
     src/print/printdialog.cpp \
     src/route/routestring.cpp \
+    src/route/routegeometry.cpp \
     src/route/routestringdialog.cpp \
     src/route/flightplanentrybuilder.cpp \
     src/common/unit.cpp \
@@ -193,6 +198,7 @@ HEADERS  += src/gui/mainwindow.h \
     src/common/mapcolors.h \
     src/mapgui/mappainternav.h \
     src/search/navicondelegate.h \
+    src/search/searchicondelegate.h \
     src/mapgui/mappainterils.h \
     src/common/maptools.h \
     src/route/routecontroller.h \
@@ -211,6 +217,8 @@ HEADERS  += src/gui/mainwindow.h \
     src/route/routenetworkradio.h \
     src/route/routenetworkairway.h \
     src/route/routenetwork.h \
+    src/route/windgrid.h \
+    src/route/routebenchmark.h \
     src/common/weatherreporter.h \
     src/connect/connectdialog.h \
     src/connect/connectclient.h \
@@ -218,6 +226,7 @@ HEADERS  += src/gui/mainwindow.h \
     src/profile/profilewidget.h \
     src/route/routemapobjectlist.h \
     src/common/aircrafttrack.h \
+    src/common/aitraffic.h \
     src/info/infocontroller.h \
     src/common/symbolpainter.h \
     src/db/databasemanager.h \
@@ -236,6 +245,7 @@ HEADERS  += src/gui/mainwindow.h \
     src/print/printsupport.h \
     src/print/printdialog.h \
     src/route/routestring.h \
+    src/route/routegeometry.h \
     src/route/routestringdialog.h \
     src/route/flightplanentrybuilder.h \
     src/common/unit.h \
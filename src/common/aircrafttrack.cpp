@@ -50,7 +50,7 @@ QDataStream& operator<<(QDataStream& dataStream, const at::AircraftTrackPos& obj
 
 void AircraftTrack::saveState()
 {
-  QFile trackFile(atools::settings::Settings::getConfigFilename(".track"));
+  QFile trackFile(getTrackFilename());
 
   if(trackFile.open(QIODevice::WriteOnly))
   {
@@ -65,10 +65,27 @@ void AircraftTrack::saveState()
 }
 
 void AircraftTrack::restoreState()
+{
+  readFromFile(getTrackFilename());
+}
+
+QString AircraftTrack::getTrackFilename()
+{
+  return atools::settings::Settings::getConfigFilename(".track");
+}
+
+AircraftTrack AircraftTrack::loadTrackThread(QString filename)
+{
+  AircraftTrack track;
+  track.readFromFile(filename);
+  return track;
+}
+
+void AircraftTrack::readFromFile(const QString& filename)
 {
   clear();
 
-  QFile trackFile(atools::settings::Settings::getConfigFilename(".track"));
+  QFile trackFile(filename);
   if(trackFile.exists())
   {
     if(trackFile.open(QIODevice::ReadOnly))
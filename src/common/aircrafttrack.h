@@ -50,6 +50,15 @@ public:
   void saveState();
   void restoreState();
 
+  /* Read track from file. Does not access the settings and can be called in a background thread. */
+  void readFromFile(const QString& filename);
+
+  /* Load a track from file. Called in a background thread on startup. */
+  static AircraftTrack loadTrackThread(QString filename);
+
+  /* Full path to the track file in the settings directory */
+  static QString getTrackFilename();
+
   void clearTrack()
   {
     clear();
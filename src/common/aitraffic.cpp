@@ -0,0 +1,181 @@
+/*****************************************************************************
+* Copyright 2015-2017 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "common/aitraffic.h"
+
+#include "geo/calculations.h"
+#include "geo/rect.h"
+
+#include <cmath>
+
+using atools::fs::sc::SimConnectAircraft;
+using atools::geo::Pos;
+using atools::geo::Rect;
+
+AiTraffic::AiTraffic()
+{
+
+}
+
+AiTraffic::~AiTraffic()
+{
+
+}
+
+void AiTraffic::update(const QVector<SimConnectAircraft>& aiAircraft)
+{
+  aircraft = aiAircraft;
+  grid.clear();
+  numMoving = 0;
+  maxGroundSpeedKts = 0.f;
+
+  for(int i = 0; i < aircraft.size(); i++)
+  {
+    const SimConnectAircraft& ac = aircraft.at(i);
+    if(ac.getGroundSpeedKts() >= MIN_EXTRAPOLATION_SPEED_KTS)
+    {
+      numMoving++;
+      maxGroundSpeedKts = std::max(maxGroundSpeedKts, ac.getGroundSpeedKts());
+    }
+
+    const Pos& pos = ac.getPosition();
+    if(pos.isValid())
+      grid[cellIndex(static_cast<int>(std::floor(pos.getLonX())),
+                     static_cast<int>(std::floor(pos.getLatY())))].append(i);
+  }
+  updateTimer.start();
+}
+
+void AiTraffic::clear()
+{
+  aircraft.clear();
+  grid.clear();
+  numMoving = 0;
+  maxGroundSpeedKts = 0.f;
+  updateTimer.invalidate();
+}
+
+QVector<int> AiTraffic::getIndexesInRect(const Rect& rect) const
+{
+  QVector<int> indexes;
+  indexesInRect(rect, indexes, false);
+  return indexes;
+}
+
+bool AiTraffic::hasAircraftInRect(const Rect& rect) const
+{
+  QVector<int> indexes;
+  indexesInRect(rect, indexes, true);
+  return !indexes.isEmpty();
+}
+
+void AiTraffic::indexesInRect(const Rect& rect, QVector<int>& indexes, bool firstOnly) const
+{
+  if(aircraft.isEmpty() || !rect.isValid())
+    return;
+
+  // Aircraft might have moved into the rectangle from cells outside
+  float marginLat = maxExtrapolationNm() / 60.f;
+
+  for(const Rect& r : rect.splitAtAntiMeridian())
+  {
+    // Longitude degrees get shorter towards the poles
+    float maxLat = std::min(std::max(std::abs(r.getNorth()), std::abs(r.getSouth())) + marginLat, 89.f);
+    float marginLon = marginLat / std::cos(atools::geo::toRadians(maxLat));
+
+    int west = static_cast<int>(std::floor(r.getWest() - marginLon));
+    int east = static_cast<int>(std::floor(r.getEast() + marginLon));
+    int south = static_cast<int>(std::floor(r.getSouth() - marginLat));
+    int north = static_cast<int>(std::floor(r.getNorth() + marginLat));
+
+    if(east - west >= 359 || (east - west + 1) * (north - south + 1) > aircraft.size())
+    {
+      // Rectangle covers more cells than aircraft - a plain scan is faster
+      for(int i = 0; i < aircraft.size(); i++)
+      {
+        if(r.contains(getExtrapolatedPosition(i)))
+        {
+          indexes.append(i);
+          if(firstOnly)
+            return;
+        }
+      }
+    }
+    else
+    {
+      for(int latY = south; latY <= north; latY++)
+      {
+        for(int lonX = west; lonX <= east; lonX++)
+        {
+          // Wrap cells extended across the anti-meridian
+          int cellLonX = lonX < -180 ? lonX + 360 : (lonX >= 180 ? lonX - 360 : lonX);
+
+          auto it = grid.constFind(cellIndex(cellLonX, latY));
+          if(it != grid.constEnd())
+          {
+            // Cells at the border are only partially covered
+            for(int index : it.value())
+            {
+              if(r.contains(getExtrapolatedPosition(index)))
+              {
+                indexes.append(index);
+                if(firstOnly)
+                  return;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+Pos AiTraffic::getExtrapolatedPosition(int index) const
+{
+  const SimConnectAircraft& ac = aircraft.at(index);
+  const Pos& pos = ac.getPosition();
+
+  if(!updateTimer.isValid() || ac.getGroundSpeedKts() < MIN_EXTRAPOLATION_SPEED_KTS || !pos.isValid())
+    return pos;
+
+  float distNm = ac.getGroundSpeedKts() * extrapolationMs() / 3600000.f;
+
+  Pos extrapolated = pos.endpoint(atools::geo::nmToMeter(distNm), ac.getTrackDegTrue()).normalize();
+  extrapolated.setAltitude(pos.getAltitude());
+  return extrapolated;
+}
+
+qint64 AiTraffic::extrapolationMs() const
+{
+  return updateTimer.isValid() ? std::min(updateTimer.elapsed(), static_cast<qint64>(MAX_EXTRAPOLATION_MS)) : 0;
+}
+
+float AiTraffic::maxExtrapolationNm() const
+{
+  return maxGroundSpeedKts * extrapolationMs() / 3600000.f;
+}
+
+bool AiTraffic::isExtrapolating() const
+{
+  return numMoving > 0 && updateTimer.isValid() && updateTimer.elapsed() < MAX_EXTRAPOLATION_MS;
+}
+
+int AiTraffic::cellIndex(int lonX, int latY)
+{
+  // Longitude 180 and latitude 90 end up in the last cell
+  return std::min(std::max(latY + 90, 0), 179) * 360 + std::min(std::max(lonX + 180, 0), 359);
+}
@@ -0,0 +1,116 @@
+/*****************************************************************************
+* Copyright 2015-2017 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_AITRAFFIC_H
+#define LITTLENAVMAP_AITRAFFIC_H
+
+#include "fs/sc/simconnectaircraft.h"
+
+#include <QHash>
+#include <QVector>
+#include <QElapsedTimer>
+
+namespace atools {
+namespace geo {
+class Rect;
+}
+}
+
+/*
+ * Stores the AI and multiplayer aircraft of the last simulator packet. Allows
+ * selection of all aircraft in a rectangle using a grid of one degree cells. Positions can be dead-reckoned
+ * by ground speed and track for the time passed since the packet was received.
+ *
+ * The grid is built from the packet positions. Rectangle queries extend the searched cells by the
+ * largest distance an aircraft can have moved and test the extrapolated positions which are drawn on the map.
+ */
+class AiTraffic
+{
+public:
+  AiTraffic();
+  ~AiTraffic();
+
+  /* Replace all aircraft with the ones from a new packet and rebuild the grid */
+  void update(const QVector<atools::fs::sc::SimConnectAircraft>& aiAircraft);
+  void clear();
+
+  /* Get the indexes of all aircraft whose extrapolated position is inside the rectangle.
+   * Rectangle can cross the anti-meridian. */
+  QVector<int> getIndexesInRect(const atools::geo::Rect& rect) const;
+
+  /* true if the extrapolated position of any aircraft is inside the rectangle */
+  bool hasAircraftInRect(const atools::geo::Rect& rect) const;
+
+  /* Get position moved along track by ground speed for the time since the last update.
+   * Time is limited to MAX_EXTRAPOLATION_MS to avoid running away when updates stop. */
+  atools::geo::Pos getExtrapolatedPosition(int index) const;
+
+  /* true if any aircraft is moving and the time since the last update is below MAX_EXTRAPOLATION_MS.
+   * Extrapolated positions do not change otherwise. */
+  bool isExtrapolating() const;
+
+  const QVector<atools::fs::sc::SimConnectAircraft>& getAircraft() const
+  {
+    return aircraft;
+  }
+
+  const atools::fs::sc::SimConnectAircraft& at(int index) const
+  {
+    return aircraft.at(index);
+  }
+
+  int size() const
+  {
+    return aircraft.size();
+  }
+
+  bool isEmpty() const
+  {
+    return aircraft.isEmpty();
+  }
+
+private:
+  /* Grid index for coordinates in degree */
+  static int cellIndex(int lonX, int latY);
+  void indexesInRect(const atools::geo::Rect& rect, QVector<int>& indexes, bool firstOnly) const;
+
+  /* Largest distance in nautical miles any aircraft was moved by extrapolation */
+  float maxExtrapolationNm() const;
+
+  /* Milliseconds used for extrapolation which is the limited time since the last update */
+  qint64 extrapolationMs() const;
+
+  static Q_DECL_CONSTEXPR int MAX_EXTRAPOLATION_MS = 5000;
+  static Q_DECL_CONSTEXPR float MIN_EXTRAPOLATION_SPEED_KTS = 1.f;
+
+  /* Copy of packet list - implicitly shared */
+  QVector<atools::fs::sc::SimConnectAircraft> aircraft;
+
+  /* Number of aircraft with a ground speed that allows extrapolation */
+  int numMoving = 0;
+
+  /* Highest ground speed of all moving aircraft */
+  float maxGroundSpeedKts = 0.f;
+
+  /* Maps one degree grid cell to indexes in aircraft */
+  QHash<int, QVector<int> > grid;
+
+  /* Time since last update */
+  QElapsedTimer updateTimer;
+};
+
+#endif // LITTLENAVMAP_AITRAFFIC_H
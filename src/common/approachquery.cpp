@@ -22,10 +22,17 @@
 #include "geo/line.h"
 
 #include "sql/sqlquery.h"
+#include "sql/sqldatabase.h"
+
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
 
 // #define DEBUG_NO_CACHE
 
 using atools::sql::SqlQuery;
+using atools::sql::SqlDatabase;
 using atools::geo::Pos;
 using atools::geo::Rect;
 using atools::geo::Line;
@@ -36,9 +43,145 @@ using atools::geo::opposedCourseDeg;
 using atools::geo::nmToMeter;
 using atools::geo::normalizeCourse;
 
+/* Connection name prefix for the procedure geometry workers */
+static const QString DATABASE_NAME_GEOMETRY("LNMDBGEOMETRY");
+
+/* Increase when changing the format of the legs blob */
+static const quint32 GEOMETRY_FORMAT_VERSION = 1;
+
+/* Number of airports calculated by all workers before the results are written. Limits memory usage. */
+static const int GEOMETRY_BATCH_AIRPORTS = 500;
+
+// Read and write legs for table approach_geometry - navaids are not stored and resolved when loading
+static void writePos(QDataStream& out, const Pos& pos)
+{
+  out << pos.getLonX() << pos.getLatY() << pos.getAltitude();
+}
+
+static Pos readPos(QDataStream& in)
+{
+  float lonX, latY, alt;
+  in >> lonX >> latY >> alt;
+  return Pos(lonX, latY, alt);
+}
+
+static void writeLeg(QDataStream& out, const maptypes::MapApproachLeg& leg)
+{
+  out << leg.approachId << leg.transitionId << leg.legId << leg.navId << leg.recNavId
+      << leg.course << leg.distance << leg.calculatedDistance << leg.calculatedTrueCourse << leg.time
+      << leg.theta << leg.rho << leg.magvar
+      << leg.fixType << leg.fixIdent << leg.fixRegion << leg.recFixType << leg.recFixIdent << leg.recFixRegion
+      << leg.turnDirection << leg.displayText << leg.remarks;
+
+  writePos(out, leg.fixPos);
+  writePos(out, leg.recFixPos);
+  writePos(out, leg.interceptPos);
+  writePos(out, leg.procedureTurnPos);
+  writePos(out, leg.line.getPos1());
+  writePos(out, leg.line.getPos2());
+
+  out << leg.geometry.size();
+  for(const Pos& pos : leg.geometry)
+    writePos(out, pos);
+
+  out << static_cast<qint32>(leg.altRestriction.descriptor) << leg.altRestriction.alt1 << leg.altRestriction.alt2
+      << static_cast<qint32>(leg.type)
+      << leg.missed << leg.flyover << leg.trueCourse << leg.transition << leg.intercept << leg.disabled;
+}
+
+static void readLeg(QDataStream& in, maptypes::MapApproachLeg& leg)
+{
+  in >> leg.approachId >> leg.transitionId >> leg.legId >> leg.navId >> leg.recNavId
+  >> leg.course >> leg.distance >> leg.calculatedDistance >> leg.calculatedTrueCourse >> leg.time
+  >> leg.theta >> leg.rho >> leg.magvar
+  >> leg.fixType >> leg.fixIdent >> leg.fixRegion >> leg.recFixType >> leg.recFixIdent >> leg.recFixRegion
+  >> leg.turnDirection >> leg.displayText >> leg.remarks;
+
+  leg.fixPos = readPos(in);
+  leg.recFixPos = readPos(in);
+  leg.interceptPos = readPos(in);
+  leg.procedureTurnPos = readPos(in);
+  Pos pos1 = readPos(in);
+  Pos pos2 = readPos(in);
+  leg.line = Line(pos1, pos2);
+
+  int numGeometry;
+  in >> numGeometry;
+  for(int i = 0; i < numGeometry; i++)
+    leg.geometry.append(readPos(in));
+
+  qint32 descriptor, type;
+  in >> descriptor >> leg.altRestriction.alt1 >> leg.altRestriction.alt2 >> type
+  >> leg.missed >> leg.flyover >> leg.trueCourse >> leg.transition >> leg.intercept >> leg.disabled;
+  leg.altRestriction.descriptor = static_cast<maptypes::MapAltRestriction::Descriptor>(descriptor);
+  leg.type = static_cast<maptypes::ApproachLegType>(type);
+}
+
+static QByteArray writeLegs(const maptypes::MapApproachLegs& legs)
+{
+  QByteArray bytes;
+  QDataStream out(&bytes, QIODevice::WriteOnly);
+  out.setVersion(QDataStream::Qt_5_5);
+  out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+  out << GEOMETRY_FORMAT_VERSION
+      << legs.approachDistance << legs.transitionDistance << legs.missedDistance
+      << legs.approachType << legs.approachSuffix << legs.approachFixIdent
+      << legs.transitionType << legs.transitionFixIdent << legs.gpsOverlay
+      << legs.runwayEnd.name << legs.runwayEnd.heading << legs.runwayEnd.secondary;
+  writePos(out, legs.runwayEnd.position);
+
+  out << legs.transitionLegs.size();
+  for(const maptypes::MapApproachLeg& leg : legs.transitionLegs)
+    writeLeg(out, leg);
+
+  out << legs.approachLegs.size();
+  for(const maptypes::MapApproachLeg& leg : legs.approachLegs)
+    writeLeg(out, leg);
+
+  return bytes;
+}
+
+/* Returns false if the format does not match */
+static bool readLegs(const QByteArray& bytes, maptypes::MapApproachLegs& legs)
+{
+  QDataStream in(bytes);
+  in.setVersion(QDataStream::Qt_5_5);
+  in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+  quint32 version;
+  in >> version;
+  if(version != GEOMETRY_FORMAT_VERSION)
+    return false;
+
+  in >> legs.approachDistance >> legs.transitionDistance >> legs.missedDistance
+  >> legs.approachType >> legs.approachSuffix >> legs.approachFixIdent
+  >> legs.transitionType >> legs.transitionFixIdent >> legs.gpsOverlay
+  >> legs.runwayEnd.name >> legs.runwayEnd.heading >> legs.runwayEnd.secondary;
+  legs.runwayEnd.position = readPos(in);
+
+  int numLegs;
+  in >> numLegs;
+  legs.transitionLegs.resize(numLegs);
+  for(maptypes::MapApproachLeg& leg : legs.transitionLegs)
+    readLeg(in, leg);
+
+  in >> numLegs;
+  legs.approachLegs.resize(numLegs);
+  for(maptypes::MapApproachLeg& leg : legs.approachLegs)
+    readLeg(in, leg);
+
+  return in.status() == QDataStream::Ok;
+}
+
 ApproachQuery::ApproachQuery(atools::sql::SqlDatabase *sqlDb, MapQuery *mapQueryParam)
   : db(sqlDb), mapQuery(mapQueryParam)
 {
+  approachCache.setMaxCost(PROCEDURE_CACHE_SIZE);
+  transitionCache.setMaxCost(PROCEDURE_CACHE_SIZE);
+
+  connect(&prefetchWatcher, &QFutureWatcher<PrefetchResult>::finished,
+          this, &ApproachQuery::prefetchProceduresThreadFinished);
 }
 
 ApproachQuery::~ApproachQuery()
@@ -212,95 +355,77 @@ void ApproachQuery::buildLegEntry(atools::sql::SqlQuery *query, maptypes::MapApp
   leg.magvar = maptypes::INVALID_MAGVAR;
 
   // Load full navaid information for fix and set fix position
-  if(leg.fixType == "W" || leg.fixType == "TW")
+  maptypes::MapSearchResult fix;
+  fetchFixNavaid(fix, leg.fixType, leg.navId);
+  if(!fix.waypoints.isEmpty())
   {
-    mapQuery->getMapObjectById(leg.navaids, maptypes::WAYPOINT, leg.navId);
-    if(!leg.navaids.waypoints.isEmpty())
-    {
-      leg.fixPos = leg.navaids.waypoints.first().position;
-      leg.magvar = leg.navaids.waypoints.first().magvar;
-    }
+    leg.fixPos = fix.waypoints.first().position;
+    leg.magvar = fix.waypoints.first().magvar;
   }
-  else if(leg.fixType == "V")
+  else if(!fix.vors.isEmpty())
   {
-    mapQuery->getMapObjectById(leg.navaids, maptypes::VOR, leg.navId);
-    if(!leg.navaids.vors.isEmpty())
-    {
-      leg.fixPos = leg.navaids.vors.first().position;
-      leg.magvar = leg.navaids.vors.first().magvar;
-    }
+    leg.fixPos = fix.vors.first().position;
+    leg.magvar = fix.vors.first().magvar;
   }
-  else if(leg.fixType == "N" || leg.fixType == "TN")
+  else if(!fix.ndbs.isEmpty())
   {
-    mapQuery->getMapObjectById(leg.navaids, maptypes::NDB, leg.navId);
-    if(!leg.navaids.ndbs.isEmpty())
-    {
-      leg.fixPos = leg.navaids.ndbs.first().position;
-      leg.magvar = leg.navaids.ndbs.first().magvar;
-    }
+    leg.fixPos = fix.ndbs.first().position;
+    leg.magvar = fix.ndbs.first().magvar;
   }
-  else if(leg.fixType == "L")
+  else if(!fix.ils.isEmpty())
   {
-    mapQuery->getMapObjectById(leg.navaids, maptypes::ILS, leg.navId);
-    if(!leg.navaids.ils.isEmpty())
-    {
-      leg.fixPos = leg.navaids.ils.first().position;
-      leg.magvar = leg.navaids.ils.first().magvar;
-    }
+    leg.fixPos = fix.ils.first().position;
+    leg.magvar = fix.ils.first().magvar;
   }
   else if(leg.fixType == "R")
-  {
-    mapQuery->getMapObjectById(leg.navaids, maptypes::RUNWAYEND, leg.navId);
-    leg.fixPos = leg.navaids.runwayEnds.isEmpty() ? Pos() : leg.navaids.runwayEnds.first().position;
-  }
+    leg.fixPos = fix.runwayEnds.isEmpty() ? Pos() : fix.runwayEnds.first().position;
+
+  // Keep only the fix types in the leg
+  leg.navaids.assign(fix);
 
   // Load navaid information for recommended fix and set fix position
   maptypes::MapSearchResult rn;
-  if(leg.recFixType == "W" || leg.recFixType == "TW")
+  fetchFixNavaid(rn, leg.recFixType, leg.recNavId);
+  float recMagvar = maptypes::INVALID_MAGVAR;
+  if(!rn.waypoints.isEmpty())
   {
-    mapQuery->getMapObjectById(rn, maptypes::WAYPOINT, leg.recNavId);
-    if(!rn.waypoints.isEmpty())
-    {
-      leg.recFixPos = rn.waypoints.first().position;
-      if(!(leg.magvar < maptypes::INVALID_MAGVAR))
-        leg.magvar = rn.waypoints.first().magvar;
-    }
+    leg.recFixPos = rn.waypoints.first().position;
+    recMagvar = rn.waypoints.first().magvar;
   }
-  else if(leg.recFixType == "V")
+  else if(!rn.vors.isEmpty())
   {
-    mapQuery->getMapObjectById(rn, maptypes::VOR, leg.recNavId);
-    if(!rn.vors.isEmpty())
-    {
-      leg.recFixPos = rn.vors.first().position;
-      if(!(leg.magvar < maptypes::INVALID_MAGVAR))
-        leg.magvar = rn.vors.first().magvar;
-    }
+    leg.recFixPos = rn.vors.first().position;
+    recMagvar = rn.vors.first().magvar;
   }
-  else if(leg.recFixType == "N" || leg.recFixType == "TN")
+  else if(!rn.ndbs.isEmpty())
   {
-    mapQuery->getMapObjectById(rn, maptypes::NDB, leg.recNavId);
-    if(!rn.ndbs.isEmpty())
-    {
-      leg.recFixPos = rn.ndbs.first().position;
-      if(!(leg.magvar < maptypes::INVALID_MAGVAR))
-        leg.magvar = rn.ndbs.first().magvar;
-    }
+    leg.recFixPos = rn.ndbs.first().position;
+    recMagvar = rn.ndbs.first().magvar;
   }
-  else if(leg.recFixType == "L")
+  else if(!rn.ils.isEmpty())
   {
-    mapQuery->getMapObjectById(rn, maptypes::ILS, leg.recNavId);
-    if(!rn.ils.isEmpty())
-    {
-      leg.recFixPos = rn.ils.first().position;
-      if(!(leg.magvar < maptypes::INVALID_MAGVAR))
-        leg.magvar = rn.ils.first().magvar;
-    }
+    leg.recFixPos = rn.ils.first().position;
+    recMagvar = rn.ils.first().magvar;
   }
   else if(leg.recFixType == "R")
-  {
-    mapQuery->getMapObjectById(rn, maptypes::RUNWAYEND, leg.recNavId);
     leg.recFixPos = rn.runwayEnds.isEmpty() ? Pos() : rn.runwayEnds.first().position;
-  }
+
+  if(!(leg.magvar < maptypes::INVALID_MAGVAR) && recMagvar < maptypes::INVALID_MAGVAR)
+    leg.magvar = recMagvar;
+}
+
+void ApproachQuery::fetchFixNavaid(maptypes::MapSearchResult& result, const QString& fixType, int navId)
+{
+  if(fixType == "W" || fixType == "TW")
+    mapQuery->getMapObjectById(result, maptypes::WAYPOINT, navId);
+  else if(fixType == "V")
+    mapQuery->getMapObjectById(result, maptypes::VOR, navId);
+  else if(fixType == "N" || fixType == "TN")
+    mapQuery->getMapObjectById(result, maptypes::NDB, navId);
+  else if(fixType == "L")
+    mapQuery->getMapObjectById(result, maptypes::ILS, navId);
+  else if(fixType == "R")
+    mapQuery->getMapObjectById(result, maptypes::RUNWAYEND, navId);
 }
 
 void ApproachQuery::updateMagvar(maptypes::MapApproachLegs& legs)
@@ -336,21 +461,28 @@ maptypes::MapApproachLegs *ApproachQuery::fetchApproachLegs(const maptypes::MapA
 {
 #ifndef DEBUG_NO_CACHE
   if(approachCache.contains(approachId))
+  {
+    cacheHits++;
     return approachCache.object(approachId);
+  }
   else
 #endif
   {
-    qDebug() << "buildApproachEntries" << airport.ident << "approachId" << approachId;
+    cacheMisses++;
+    if(!quiet)
+      qDebug() << "buildApproachEntries" << airport.ident << "approachId" << approachId;
 
-    maptypes::MapApproachLegs *legs = buildApproachLegs(airport, approachId);
-    postProcessLegs(airport, *legs);
+    maptypes::MapApproachLegs *legs = loadProcedureGeometry(airport, approachId, -1);
+    if(legs == nullptr)
+    {
+      // Copy of the shared unprocessed legs - legs are detached when modified
+      legs = new maptypes::MapApproachLegs(*fetchApproachBaseLegs(airport, approachId));
+      postProcessLegs(airport, *legs);
+    }
 
     if(!legs->isEmpty())
     {
-      for(int i = 0; i < legs->size(); i++)
-        approachLegIndex.insert(legs->at(i).legId, std::make_pair(approachId, i));
-
-      approachCache.insert(approachId, legs);
+      insertApproachLegs(approachId, legs);
       return legs;
     }
     else
@@ -367,55 +499,61 @@ maptypes::MapApproachLegs *ApproachQuery::fetchTransitionLegs(const maptypes::Ma
 {
 #ifndef DEBUG_NO_CACHE
   if(transitionCache.contains(transitionId))
+  {
+    cacheHits++;
     return transitionCache.object(transitionId);
+  }
   else
 #endif
   {
-    qDebug() << "buildApproachEntries" << airport.ident << "approachId" << approachId
-             << "transitionId" << transitionId;
+    cacheMisses++;
+    if(!quiet)
+      qDebug() << "buildApproachEntries" << airport.ident << "approachId" << approachId
+               << "transitionId" << transitionId;
 
-    transitionLegQuery->bindValue(":id", transitionId);
-    transitionLegQuery->exec();
-
-    maptypes::MapApproachLegs *legs = new maptypes::MapApproachLegs;
-    legs->ref.airportId = airport.id;
-    legs->ref.approachId = approachId;
-    legs->ref.transitionId = transitionId;
-
-    while(transitionLegQuery->next())
+    maptypes::MapApproachLegs *legs = loadProcedureGeometry(airport, approachId, transitionId);
+    if(legs == nullptr)
     {
-      legs->transitionLegs.append(buildTransitionLegEntry());
-      legs->transitionLegs.last().approachId = approachId;
-      legs->transitionLegs.last().transitionId = transitionId;
-    }
+      transitionLegQuery->bindValue(":id", transitionId);
+      transitionLegQuery->exec();
 
-    // Add a full copy of the approach because approach legs will be modified for different transitions
-    maptypes::MapApproachLegs *approach = buildApproachLegs(airport, approachId);
-    legs->approachLegs = approach->approachLegs;
-    legs->runwayEnd = approach->runwayEnd;
-    legs->approachType = approach->approachType;
-    legs->approachSuffix = approach->approachSuffix;
-    legs->approachFixIdent = approach->approachFixIdent;
-    legs->gpsOverlay = approach->gpsOverlay;
-    delete approach;
+      legs = new maptypes::MapApproachLegs;
+      legs->ref.airportId = airport.id;
+      legs->ref.approachId = approachId;
+      legs->ref.transitionId = transitionId;
 
-    postProcessLegs(airport, *legs);
+      while(transitionLegQuery->next())
+      {
+        legs->transitionLegs.append(buildTransitionLegEntry());
+        legs->transitionLegs.last().approachId = approachId;
+        legs->transitionLegs.last().transitionId = transitionId;
+      }
 
-    transitionQuery->bindValue(":id", transitionId);
-    transitionQuery->exec();
-    if(transitionQuery->next())
-    {
-      legs->transitionType = transitionQuery->value("type").toString();
-      legs->transitionFixIdent = transitionQuery->value("fix_ident").toString();
+      // Add a copy of the shared unprocessed approach because approach legs will be modified for different
+      // transitions. The implicitly shared leg vector is detached only when the legs are modified.
+      const maptypes::MapApproachLegs *approach = fetchApproachBaseLegs(airport, approachId);
+      legs->approachLegs = approach->approachLegs;
+      legs->runwayEnd = approach->runwayEnd;
+      legs->approachType = approach->approachType;
+      legs->approachSuffix = approach->approachSuffix;
+      legs->approachFixIdent = approach->approachFixIdent;
+      legs->gpsOverlay = approach->gpsOverlay;
+
+      postProcessLegs(airport, *legs);
+
+      transitionQuery->bindValue(":id", transitionId);
+      transitionQuery->exec();
+      if(transitionQuery->next())
+      {
+        legs->transitionType = transitionQuery->value("type").toString();
+        legs->transitionFixIdent = transitionQuery->value("fix_ident").toString();
+      }
+      transitionQuery->finish();
     }
-    transitionQuery->finish();
 
     if(!legs->isEmpty())
     {
-      for(int i = 0; i < legs->size(); ++i)
-        transitionLegIndex.insert(legs->at(i).legId, std::make_pair(transitionId, i));
-
-      transitionCache.insert(transitionId, legs);
+      insertTransitionLegs(transitionId, legs);
       return legs;
     }
     else
@@ -427,6 +565,34 @@ maptypes::MapApproachLegs *ApproachQuery::fetchTransitionLegs(const maptypes::Ma
   }
 }
 
+void ApproachQuery::insertApproachLegs(int approachId, maptypes::MapApproachLegs *legs)
+{
+  for(int i = 0; i < legs->size(); i++)
+    approachLegIndex.insert(legs->at(i).legId, std::make_pair(approachId, i));
+
+  approachCache.insert(approachId, legs);
+}
+
+void ApproachQuery::insertTransitionLegs(int transitionId, maptypes::MapApproachLegs *legs)
+{
+  for(int i = 0; i < legs->size(); ++i)
+    transitionLegIndex.insert(legs->at(i).legId, std::make_pair(transitionId, i));
+
+  transitionCache.insert(transitionId, legs);
+}
+
+const maptypes::MapApproachLegs *ApproachQuery::fetchApproachBaseLegs(const maptypes::MapAirport& airport,
+                                                                    int approachId)
+{
+  maptypes::MapApproachLegs *legs = approachBaseCache.object(approachId);
+  if(legs == nullptr)
+  {
+    legs = buildApproachLegs(airport, approachId);
+    approachBaseCache.insert(approachId, legs);
+  }
+  return legs;
+}
+
 maptypes::MapApproachLegs *ApproachQuery::buildApproachLegs(const maptypes::MapAirport& airport, int approachId)
 {
   approachLegQuery->bindValue(":id", approachId);
@@ -477,6 +643,9 @@ void ApproachQuery::postProcessLegs(const maptypes::MapAirport& airport, maptype
 
   updateBoundingRectangle(legs);
 
+  if(quiet)
+    return;
+
   qDebug() << "---------------------------------";
   qDebug() << "appr dist" << legs.approachDistance << "trans dist" << legs.transitionDistance
            << "missed dist" << legs.missedDistance;
@@ -950,10 +1119,458 @@ void ApproachQuery::updateBoundingRectangle(maptypes::MapApproachLegs& legs)
   }
 }
 
+float ApproachQuery::getCacheHitRate() const
+{
+  int total = cacheHits + cacheMisses;
+  return total > 0 ? static_cast<float>(cacheHits) / static_cast<float>(total) : 0.f;
+}
+
+void ApproachQuery::prefetchProcedures(const QList<maptypes::MapAirport>& airports)
+{
+  for(const maptypes::MapAirport& airport : airports)
+  {
+    if(airport.isValid() && !isPrefetched(airport.id))
+    {
+      prefetchedIds.insert(airport.id, PrefetchedIds());
+      prefetchAirports.append(airport);
+    }
+  }
+
+  // Will be picked up when a running prefetch is finished
+  if(!prefetchRunning)
+    startPrefetch();
+}
+
+bool ApproachQuery::isPrefetched(int airportId)
+{
+  QHash<int, PrefetchedIds>::const_iterator it = prefetchedIds.constFind(airportId);
+  if(it == prefetchedIds.constEnd())
+    return false;
+
+  // Procedures might have been evicted from the cache in the meantime
+  bool cached = true;
+  for(int id : it.value().approachIds)
+    cached &= approachCache.contains(id);
+  for(int id : it.value().transitionIds)
+    cached &= transitionCache.contains(id);
+
+  if(!cached)
+    prefetchedIds.remove(airportId);
+  return cached;
+}
+
+void ApproachQuery::startPrefetch()
+{
+  if(prefetchAirports.isEmpty() || approachLegQuery == nullptr)
+    return;
+
+  qDebug() << Q_FUNC_INFO << "airports" << prefetchAirports.size();
+
+  prefetchCanceled = false;
+  prefetchRunning = true;
+  prefetchFuture = QtConcurrent::run(this, &ApproachQuery::prefetchProceduresThread,
+                                     db->databaseName(), prefetchAirports);
+  prefetchWatcher.setFuture(prefetchFuture);
+  prefetchAirports.clear();
+}
+
+/* Runs in a background thread with its own database connection and query objects.
+ * Does not touch any members except the cancel flag. */
+ApproachQuery::PrefetchResult ApproachQuery::prefetchProceduresThread(QString databaseName,
+                                                                     QList<maptypes::MapAirport> airports)
+{
+  PrefetchResult result;
+
+  // Need empty block to delete prefetchDb before removing driver
+  {
+    // A database connection can only be used in the thread that created it
+    SqlDatabase prefetchDb = SqlDatabase::addDatabase(DATABASE_TYPE, DATABASE_NAME_PREFETCH);
+    try
+    {
+      prefetchDb.setDatabaseName(databaseName);
+      prefetchDb.open();
+
+      // Separate query objects for this thread - not connected to any signals
+      MapQuery threadMapQuery(nullptr, &prefetchDb);
+      threadMapQuery.initQueries();
+      ApproachQuery threadQuery(&prefetchDb, &threadMapQuery);
+      threadQuery.setQuiet(true);
+      threadQuery.initQueries();
+
+      for(const maptypes::MapAirport& airport : airports)
+      {
+        // Copy since the thread query will be deleted
+        threadQuery.fetchAllProcedures(airport, prefetchCanceled,
+                                       [&result](int approachId, int transitionId,
+                                                 const maptypes::MapApproachLegs& legs) -> void
+        {
+          if(transitionId == -1)
+            result.approaches.append(std::make_pair(approachId, new maptypes::MapApproachLegs(legs)));
+          else
+            result.transitions.append(std::make_pair(transitionId, new maptypes::MapApproachLegs(legs)));
+        });
+      }
+
+      threadQuery.deInitQueries();
+      threadMapQuery.deInitQueries();
+      prefetchDb.close();
+    }
+    catch(std::exception& e)
+    {
+      // Not critical - procedures will be loaded on demand
+      qWarning() << Q_FUNC_INFO << "Error prefetching procedures" << e.what();
+    }
+    catch(...)
+    {
+      qWarning() << Q_FUNC_INFO << "Unknown error prefetching procedures";
+    }
+  }
+  SqlDatabase::removeDatabase(DATABASE_NAME_PREFETCH);
+
+  return result;
+}
+
+void ApproachQuery::fetchAllProcedures(const maptypes::MapAirport& airport, const std::atomic_bool& canceled,
+                                       const std::function<void(int, int,
+                                                                const maptypes::MapApproachLegs&)>& callback)
+{
+  SqlQuery approachIdQuery(db);
+  approachIdQuery.prepare("select approach_id from approach where airport_id = :id");
+  SqlQuery transitionIdQuery(db);
+  transitionIdQuery.prepare("select transition_id from transition where approach_id = :id");
+
+  QVector<int> approachIds;
+  approachIdQuery.bindValue(":id", airport.id);
+  approachIdQuery.exec();
+  while(approachIdQuery.next())
+    approachIds.append(approachIdQuery.value("approach_id").toInt());
+
+  for(int approachId : approachIds)
+  {
+    if(canceled)
+      break;
+
+    const maptypes::MapApproachLegs *legs = fetchApproachLegs(airport, approachId);
+    if(legs != nullptr)
+      callback(approachId, -1, *legs);
+
+    transitionIdQuery.bindValue(":id", approachId);
+    transitionIdQuery.exec();
+    while(transitionIdQuery.next())
+    {
+      int transitionId = transitionIdQuery.value("transition_id").toInt();
+      legs = fetchTransitionLegs(airport, approachId, transitionId);
+      if(legs != nullptr)
+        callback(approachId, transitionId, *legs);
+    }
+  }
+}
+
+void ApproachQuery::prefetchProceduresThreadFinished()
+{
+  if(!prefetchRunning)
+    // Already consumed by cancelPrefetch
+    return;
+
+  prefetchRunning = false;
+  PrefetchResult result = prefetchFuture.result();
+
+  // Keep procedures that were loaded in the meantime since callers might hold pointers to them
+  for(const std::pair<int, maptypes::MapApproachLegs *>& entry : result.approaches)
+  {
+    prefetchedIds[entry.second->ref.airportId].approachIds.append(entry.first);
+    if(!approachCache.contains(entry.first))
+      insertApproachLegs(entry.first, entry.second);
+    else
+      delete entry.second;
+  }
+
+  for(const std::pair<int, maptypes::MapApproachLegs *>& entry : result.transitions)
+  {
+    prefetchedIds[entry.second->ref.airportId].transitionIds.append(entry.first);
+    if(!transitionCache.contains(entry.first))
+      insertTransitionLegs(entry.first, entry.second);
+    else
+      delete entry.second;
+  }
+
+  qDebug() << Q_FUNC_INFO << "approaches" << result.approaches.size()
+           << "transitions" << result.transitions.size()
+           << "cache hit rate" << getCacheHitRate();
+
+  // Start next run if airports were added while running
+  startPrefetch();
+}
+
+void ApproachQuery::cancelPrefetch()
+{
+  if(prefetchRunning)
+  {
+    prefetchCanceled = true;
+    prefetchFuture.waitForFinished();
+    deletePrefetchResult(prefetchFuture.result());
+    prefetchRunning = false;
+  }
+  prefetchAirports.clear();
+  prefetchedIds.clear();
+}
+
+void ApproachQuery::deletePrefetchResult(const PrefetchResult& result)
+{
+  for(const std::pair<int, maptypes::MapApproachLegs *>& entry : result.approaches)
+    delete entry.second;
+  for(const std::pair<int, maptypes::MapApproachLegs *>& entry : result.transitions)
+    delete entry.second;
+}
+
+QString ApproachQuery::procedureGeometrySignature()
+{
+  return QLocale().name() + " " + Unit::getUnitDistStr();
+}
+
+void ApproachQuery::createProcedureGeometry(atools::sql::SqlDatabase *sqlDb, const QString& databaseFile,
+                                            const std::atomic_bool& canceled)
+{
+  try
+  {
+    createProcedureGeometryInternal(sqlDb, databaseFile, canceled);
+  }
+  catch(std::exception& e)
+  {
+    // Not critical - procedures will be calculated on demand
+    qWarning() << Q_FUNC_INFO << "Error creating procedure geometry" << e.what();
+    dropProcedureGeometry(sqlDb);
+  }
+  catch(...)
+  {
+    qWarning() << Q_FUNC_INFO << "Unknown error creating procedure geometry";
+    dropProcedureGeometry(sqlDb);
+  }
+}
+
+void ApproachQuery::dropProcedureGeometry(atools::sql::SqlDatabase *sqlDb)
+{
+  try
+  {
+    sqlDb->rollback();
+    SqlQuery(sqlDb).exec("drop table if exists approach_geometry_signature");
+    SqlQuery(sqlDb).exec("drop table if exists approach_geometry");
+    sqlDb->commit();
+  }
+  catch(std::exception& e)
+  {
+    qWarning() << Q_FUNC_INFO << "Error dropping procedure geometry" << e.what();
+  }
+}
+
+void ApproachQuery::createProcedureGeometryInternal(atools::sql::SqlDatabase *sqlDb, const QString& databaseFile,
+                                                    const std::atomic_bool& canceled)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  QVector<int> airportIds;
+  SqlQuery airportQuery(sqlDb);
+  airportQuery.exec("select distinct airport_id from approach");
+  while(airportQuery.next())
+    airportIds.append(airportQuery.value("airport_id").toInt());
+
+  // The signature is written last so an incomplete table is never used
+  SqlQuery(sqlDb).exec("drop table if exists approach_geometry_signature");
+  SqlQuery(sqlDb).exec("drop table if exists approach_geometry");
+  SqlQuery(sqlDb).exec("create table approach_geometry ("
+                       "approach_id integer not null, "
+                       "transition_id integer not null, "
+                       "legs blob not null)");
+  sqlDb->commit();
+
+  SqlQuery insertQuery(sqlDb);
+  insertQuery.prepare("insert into approach_geometry (approach_id, transition_id, legs) "
+                      "values(:approachId, :transitionId, :legs)");
+
+  int numThreads = std::max(1, QThread::idealThreadCount());
+  int numRows = 0;
+  for(int batchStart = 0; batchStart < airportIds.size() && !canceled; batchStart += GEOMETRY_BATCH_AIRPORTS)
+  {
+    // Distribute airports evenly since procedure numbers vary a lot
+    int batchEnd = std::min(batchStart + GEOMETRY_BATCH_AIRPORTS, airportIds.size());
+    QVector<QVector<int> > chunks(numThreads);
+    for(int i = batchStart; i < batchEnd; i++)
+      chunks[i % numThreads].append(airportIds.at(i));
+
+    QList<QFuture<QVector<GeometryRow> > > futures;
+    for(int i = 0; i < numThreads; i++)
+      futures.append(QtConcurrent::run(&ApproachQuery::createProcedureGeometryThread, databaseFile, chunks.at(i),
+                                       DATABASE_NAME_GEOMETRY + QString::number(i), &canceled));
+
+    // Join all workers before writing to avoid locking conflicts with their read connections
+    QVector<QVector<GeometryRow> > results;
+    for(QFuture<QVector<GeometryRow> >& future : futures)
+      results.append(future.result());
+
+    if(canceled)
+      break;
+
+    for(const QVector<GeometryRow>& rows : results)
+    {
+      for(const GeometryRow& row : rows)
+      {
+        insertQuery.bindValue(":approachId", row.approachId);
+        insertQuery.bindValue(":transitionId", row.transitionId);
+        insertQuery.bindValue(":legs", row.legs);
+        insertQuery.exec();
+        numRows++;
+      }
+    }
+    sqlDb->commit();
+  }
+
+  if(canceled)
+  {
+    dropProcedureGeometry(sqlDb);
+    return;
+  }
+
+  SqlQuery(sqlDb).exec("create unique index if not exists idx_approach_geometry "
+                       "on approach_geometry (approach_id, transition_id)");
+
+  SqlQuery(sqlDb).exec("create table approach_geometry_signature (signature varchar(50) not null)");
+  SqlQuery signatureQuery(sqlDb);
+  signatureQuery.prepare("insert into approach_geometry_signature (signature) values(:signature)");
+  signatureQuery.bindValue(":signature", procedureGeometrySignature());
+  signatureQuery.exec();
+  sqlDb->commit();
+
+  qInfo() << Q_FUNC_INFO << "airports" << airportIds.size() << "procedures" << numRows
+          << "threads" << numThreads << "time" << timer.elapsed() << "ms";
+}
+
+/* Runs in a worker thread with its own connection and query objects */
+QVector<ApproachQuery::GeometryRow> ApproachQuery::createProcedureGeometryThread(QString databaseFile,
+                                                                                 QVector<int> airportIds,
+                                                                                 QString connectionName,
+                                                                                 const std::atomic_bool *canceled)
+{
+  QVector<GeometryRow> rows;
+
+  // Need empty block to delete geometryDb before removing driver
+  {
+    SqlDatabase geometryDb = SqlDatabase::addDatabase("QSQLITE", connectionName);
+    try
+    {
+      geometryDb.setDatabaseName(databaseFile);
+      geometryDb.open();
+
+      MapQuery threadMapQuery(nullptr, &geometryDb);
+      threadMapQuery.initQueries();
+      ApproachQuery threadQuery(&geometryDb, &threadMapQuery);
+      threadQuery.setQuiet(true);
+      threadQuery.initQueries();
+
+      for(int airportId : airportIds)
+      {
+        if(*canceled)
+          break;
+
+        threadQuery.fetchAllProcedures(threadMapQuery.getAirportById(airportId), *canceled,
+                                       [&rows](int approachId, int transitionId,
+                                               const maptypes::MapApproachLegs& legs) -> void
+        {
+          rows.append({approachId, transitionId, writeLegs(legs)});
+        });
+      }
+
+      threadQuery.deInitQueries();
+      threadMapQuery.deInitQueries();
+      geometryDb.close();
+    }
+    catch(std::exception& e)
+    {
+      // Not critical - procedures will be calculated on demand
+      qWarning() << Q_FUNC_INFO << "Error creating procedure geometry" << e.what();
+    }
+    catch(...)
+    {
+      qWarning() << Q_FUNC_INFO << "Unknown error creating procedure geometry";
+    }
+  }
+  SqlDatabase::removeDatabase(connectionName);
+
+  return rows;
+}
+
+maptypes::MapApproachLegs *ApproachQuery::loadProcedureGeometry(const maptypes::MapAirport& airport,
+                                                                int approachId, int transitionId)
+{
+  if(geometryQuery == nullptr)
+    return nullptr;
+
+  maptypes::MapApproachLegs *legs = nullptr;
+
+  geometryQuery->bindValue(":approachId", approachId);
+  geometryQuery->bindValue(":transitionId", transitionId);
+  geometryQuery->exec();
+  if(geometryQuery->next())
+  {
+    legs = new maptypes::MapApproachLegs;
+    if(readLegs(geometryQuery->value("legs").toByteArray(), *legs))
+    {
+      legs->ref.airportId = airport.id;
+      legs->ref.approachId = approachId;
+      legs->ref.transitionId = transitionId;
+
+      for(int i = 0; i < legs->size(); i++)
+        fetchLegNavaids((*legs)[i], legs->runwayEnd);
+
+      updateBoundingRectangle(*legs);
+    }
+    else
+    {
+      qWarning() << Q_FUNC_INFO << "Cannot read legs for approach" << approachId << "transition" << transitionId;
+      delete legs;
+      legs = nullptr;
+    }
+  }
+  geometryQuery->finish();
+  return legs;
+}
+
+void ApproachQuery::fetchLegNavaids(maptypes::MapApproachLeg& leg, const maptypes::MapRunwayEnd& runwayEnd)
+{
+  maptypes::MapSearchResult fix;
+  if(leg.legId >= RUNWAY_LEG_ID_BASE)
+    // Artificial runway leg which is not in the database
+    fix.runwayEnds.append(runwayEnd);
+  else
+    fetchFixNavaid(fix, leg.fixType, leg.navId);
+
+  leg.navaids.assign(fix);
+}
+
 void ApproachQuery::initQueries()
 {
   deInitQueries();
 
+  geometryTableSignature.clear();
+  SqlQuery tableQuery(db);
+  tableQuery.exec("select count(1) from sqlite_master where type = 'table' and "
+                  "name in ('approach_geometry', 'approach_geometry_signature')");
+  if(tableQuery.next() && tableQuery.value(0).toInt() == 2)
+  {
+    // Table contains exactly one row if geometry was created completely
+    SqlQuery signatureQuery(db);
+    signatureQuery.exec("select signature from approach_geometry_signature");
+    QStringList signatures;
+    while(signatureQuery.next())
+      signatures.append(signatureQuery.value("signature").toString());
+
+    if(signatures.size() == 1)
+      geometryTableSignature = signatures.first();
+    else
+      qWarning() << Q_FUNC_INFO << "Invalid procedure geometry signatures" << signatures;
+  }
+  updateGeometryQuery();
+
   approachLegQuery = new SqlQuery(db);
   approachLegQuery->prepare("select * from approach_leg where approach_id = :id "
                             "order by approach_leg_id");
@@ -980,16 +1597,53 @@ void ApproachQuery::initQueries()
                          "from approach where approach_id = :id");
 }
 
+void ApproachQuery::optionsChanged()
+{
+  if(approachLegQuery != nullptr)
+    updateGeometryQuery();
+}
+
+void ApproachQuery::updateGeometryQuery()
+{
+  // Ignore stored legs if texts were created with other units or language
+  bool matches = !geometryTableSignature.isEmpty() && geometryTableSignature == procedureGeometrySignature();
+
+  if(matches && geometryQuery == nullptr)
+  {
+    geometryQuery = new SqlQuery(db);
+    geometryQuery->prepare("select legs from approach_geometry "
+                           "where approach_id = :approachId and transition_id = :transitionId");
+  }
+  else if(!matches && geometryQuery != nullptr)
+  {
+    delete geometryQuery;
+    geometryQuery = nullptr;
+  }
+
+  if(!matches && !geometryTableSignature.isEmpty())
+    qInfo() << Q_FUNC_INFO << "Not using procedure geometry table";
+}
+
 void ApproachQuery::deInitQueries()
 {
+  // Database might be closed or replaced
+  cancelPrefetch();
+
+  qDebug() << Q_FUNC_INFO << "cache hits" << cacheHits << "misses" << cacheMisses;
+  cacheHits = cacheMisses = 0;
+
   approachCache.clear();
   transitionCache.clear();
+  approachBaseCache.clear();
   approachLegIndex.clear();
   transitionLegIndex.clear();
 
   delete approachLegQuery;
   approachLegQuery = nullptr;
 
+  delete geometryQuery;
+  geometryQuery = nullptr;
+
   delete transitionLegQuery;
   transitionLegQuery = nullptr;
 
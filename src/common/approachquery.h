@@ -23,6 +23,11 @@
 
 #include <QCache>
 #include <QApplication>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <atomic>
 #include <functional>
 
 namespace atools {
@@ -35,10 +40,12 @@ class SqlQuery;
 class MapQuery;
 
 /* Loads and caches approaches and transitions. The corresponding approach is also loaded and cached if a
- * transition is loaded since legs depend on each other.*/
-class ApproachQuery
+ * transition is loaded since legs depend on each other.
+ * All procedures of flight plan airports can be built in a background thread ahead of use. */
+class ApproachQuery :
+  public QObject
 {
-  Q_DECLARE_TR_FUNCTIONS(ApproachQuery)
+  Q_OBJECT
 
 public:
   ApproachQuery(atools::sql::SqlDatabase *sqlDb, MapQuery *mapQueryParam);
@@ -53,6 +60,29 @@ public:
   /* Get transition and its approach */
   const maptypes::MapApproachLegs *getTransitionLegs(const maptypes::MapAirport& airport, int transitionId);
 
+  /* Build all approaches and transitions of the given airports in a background thread and add them to the
+   * cache when done. Airports that were already prefetched are skipped. */
+  void prefetchProcedures(const QList<maptypes::MapAirport>& airports);
+
+  /* Ratio of approach and transition requests answered from the cache. 0 to 1. */
+  float getCacheHitRate() const;
+
+  /* Stop using table approach_geometry if the units or language do not match the stored leg texts anymore.
+   * Has to be called after Unit::optionsChanged. */
+  void optionsChanged();
+
+  /* Suppress the per procedure debug output. Used for bulk loading in worker threads. */
+  void setQuiet(bool value)
+  {
+    quiet = value;
+  }
+
+  /* Compute legs for all procedures of all airports and store them in table approach_geometry. Called in the
+   * scenery library loading thread after loading. Airports are split across worker threads which use their own
+   * connection to databaseFile. Errors are logged and the table is dropped since it is optional. */
+  static void createProcedureGeometry(atools::sql::SqlDatabase *sqlDb, const QString& databaseFile,
+                                      const std::atomic_bool& canceled);
+
   /* Create all queries */
   void initQueries();
 
@@ -60,6 +90,62 @@ public:
   void deInitQueries();
 
 private:
+  /* Result of the background prefetch. Legs are passed to the cache in the main thread. */
+  struct PrefetchResult
+  {
+    QList<std::pair<int, maptypes::MapApproachLegs *> > approaches, transitions;
+  };
+
+  /* Serialized legs of one procedure for table approach_geometry */
+  struct GeometryRow
+  {
+    int approachId, transitionId;
+    QByteArray legs;
+  };
+
+  /* Calculates in batches of airports and writes each batch after all workers are done */
+  static void createProcedureGeometryInternal(atools::sql::SqlDatabase *sqlDb, const QString& databaseFile,
+                                              const std::atomic_bool& canceled);
+
+  /* Remove incomplete geometry and its signature after errors or canceling */
+  static void dropProcedureGeometry(atools::sql::SqlDatabase *sqlDb);
+
+  static QVector<GeometryRow> createProcedureGeometryThread(QString databaseFile, QVector<int> airportIds,
+                                                             QString connectionName,
+                                                             const std::atomic_bool *canceled);
+
+  /* Load precomputed legs from table approach_geometry. transitionId is -1 for approaches.
+   * Returns null if not available. */
+  maptypes::MapApproachLegs *loadProcedureGeometry(const maptypes::MapAirport& airport, int approachId,
+                                                   int transitionId);
+
+  /* Resolve navaids for a leg loaded from table approach_geometry */
+  void fetchLegNavaids(maptypes::MapApproachLeg& leg, const maptypes::MapRunwayEnd& runwayEnd);
+
+  /* Load the navaid for a fix type like "W", "V", "N", "L" or "R" into result. Does nothing for unknown types. */
+  void fetchFixNavaid(maptypes::MapSearchResult& result, const QString& fixType, int navId);
+
+  /* Units and language the display texts in the stored legs were created with */
+  static QString procedureGeometrySignature();
+
+  PrefetchResult prefetchProceduresThread(QString databaseName, QList<maptypes::MapAirport> airports);
+
+  /* Load all approaches and transitions of the airport and pass each one to callback.
+   * transitionId is -1 for approaches. */
+  void fetchAllProcedures(const maptypes::MapAirport& airport, const std::atomic_bool& canceled,
+                          const std::function<void(int approachId, int transitionId,
+                                                   const maptypes::MapApproachLegs& legs)>& callback);
+  void prefetchProceduresThreadFinished();
+  void startPrefetch();
+
+  /* Wait for a running prefetch and drop its results */
+  void cancelPrefetch();
+  static void deletePrefetchResult(const PrefetchResult& result);
+
+  /* Insert into cache and add legs to the leg index */
+  void insertApproachLegs(int approachId, maptypes::MapApproachLegs *legs);
+  void insertTransitionLegs(int transitionId, maptypes::MapApproachLegs *legs);
+
   maptypes::MapApproachLeg buildTransitionLegEntry();
   maptypes::MapApproachLeg buildApproachLegEntry();
   void buildLegEntry(atools::sql::SqlQuery *query, maptypes::MapApproachLeg& leg);
@@ -81,6 +167,9 @@ private:
   void updateBoundingRectangle(maptypes::MapApproachLegs& legs);
 
   maptypes::MapApproachLegs *buildApproachLegs(const maptypes::MapAirport& airport, int approachId);
+
+  /* Get unprocessed approach legs which are shared between the approach and all its transitions */
+  const maptypes::MapApproachLegs *fetchApproachBaseLegs(const maptypes::MapAirport& airport, int approachId);
   maptypes::MapApproachLegs *fetchApproachLegs(const maptypes::MapAirport& airport, int approachId);
   maptypes::MapApproachLegs *fetchTransitionLegs(const maptypes::MapAirport& airport, int approachId, int transitionId);
 
@@ -89,13 +178,57 @@ private:
   *transitionIdForLegQuery = nullptr, *approachIdForTransQuery = nullptr,
   *runwayEndIdQuery = nullptr, *transitionQuery = nullptr, *approachQuery = nullptr;
 
+  /* Only prepared if table approach_geometry exists and matches the current units */
+  atools::sql::SqlQuery *geometryQuery = nullptr;
+
+  /* Signature stored in table approach_geometry_signature or empty if the geometry is not available */
+  QString geometryTableSignature;
+
+  /* Create or delete geometryQuery depending on the table signature */
+  void updateGeometryQuery();
+
+  bool quiet = false;
+
   /* approach ID and transition ID to full lists
    * The approach also has to be stored for transitions since the handover can modify approach legs (CI legs, etc.) */
   QCache<int, maptypes::MapApproachLegs> approachCache, transitionCache;
 
+  /* Approach ID to unprocessed approach legs as loaded from the database */
+  QCache<int, maptypes::MapApproachLegs> approachBaseCache;
+
   /* maps leg ID to approach/transition ID and index in list */
   QHash<int, std::pair<int, int> > approachLegIndex, transitionLegIndex;
 
+  /* Background loading of procedures */
+  QFuture<PrefetchResult> prefetchFuture;
+  QFutureWatcher<PrefetchResult> prefetchWatcher;
+  bool prefetchRunning = false;
+  std::atomic_bool prefetchCanceled{false};
+
+  /* Approach and transition ids loaded by a prefetch for one airport */
+  struct PrefetchedIds
+  {
+    QVector<int> approachIds, transitionIds;
+  };
+
+  /* true if the airport was prefetched and none of its procedures were evicted from the cache.
+   * Removes the airport from prefetchedIds otherwise. */
+  bool isPrefetched(int airportId);
+
+  /* Airports waiting for the next prefetch run and all airports already requested */
+  QList<maptypes::MapAirport> prefetchAirports;
+  QHash<int, PrefetchedIds> prefetchedIds;
+
+  /* Cache statistics */
+  int cacheHits = 0, cacheMisses = 0;
+
+  /* Separate connection for the prefetch thread */
+  const QString DATABASE_NAME_PREFETCH = "LNMDBPROCEDURES";
+  const QString DATABASE_TYPE = "QSQLITE";
+
+  /* Large enough to keep all procedures of departure and destination */
+  Q_DECL_CONSTEXPR static int PROCEDURE_CACHE_SIZE = 2000;
+
   MapQuery *mapQuery = nullptr;
 
   /* Use this value as an id base for the artifical runway legs. Add id of the predecessor to it to be able to find the
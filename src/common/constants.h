@@ -78,6 +78,7 @@ const QString MAP_OVERLAY_VISIBLE = "Map/OverlayVisible";
 const QString NAVCONNECT_REMOTEHOSTS = "NavConnect/RemoteHosts";
 const QString NAVCONNECT_REMOTE = "NavConnect/Remote";
 const QString OPTIONS_FOREIGNKEYS = "Options/ForeignKeys";
+const QString OPTIONS_PROCEDURE_GEOMETRY = "Options/PrecomputeProcedureGeometry";
 const QString ROUTE_FILENAME = "Route/Filename";
 const QString ROUTE_FILENAMESRECENT = "Route/FilenamesRecent";
 const QString ROUTE_FILENAMESKMLRECENT = "Route/FilenamesKmlRecent";
@@ -85,6 +86,8 @@ const QString ROUTE_VIEW = "Route/View";
 const QString ROUTE_PRINT_DIALOG = "Route/PrintWidget";
 const QString ROUTE_STRING_DIALOG_SIZE = "Route/StringDialogSize";
 const QString ROUTE_STRING_DIALOG_SPLITTER = "Route/StringDialogSplitter";
+const QString ROUTE_WIND_FILE = "Route/WindFile";
+const QString ROUTE_WIND_TRUE_AIRSPEED = "Route/WindTrueAirspeed";
 const QString SEARCHTAB_AIRPORT_WIDGET = "SearchPaneAirport/Widget";
 const QString SEARCHTAB_NAV_WIDGET = "SearchPaneNav/Widget";
 const QString SEARCHTAB_AIRPORT_VIEW_WIDGET = "SearchPaneAirport/WidgetView";
@@ -139,6 +142,8 @@ const QString DATABASE_DIR = "little_navmap_db";
 const QString DATABASE_PREFIX = "little_navmap_";
 const QString DATABASE_SUFFIX = ".sqlite";
 const QString DATABASE_BACKUP_SUFFIX = "-backup";
+/* New database is loaded into a file with this suffix and renamed when done */
+const QString DATABASE_LOADING_SUFFIX = "-loading";
 
 /* This is the default configuration file for reading the scenery library.
  * It can be overridden by placing a  file with the same name into
@@ -21,8 +21,12 @@
 #include "geo/line.h"
 
 #include <marble/ViewportParams.h>
+#include <marble/AbstractProjection.h>
+#include <marble/Quaternion.h>
 
 #include <QLineF>
+#include <QtMath>
+#include <algorithm>
 
 using namespace Marble;
 using namespace atools::geo;
@@ -221,6 +225,200 @@ Pos CoordinateConverter::sToW(const QPointF& point) const
   return sToW(point.x(), point.y());
 }
 
+int CoordinateConverter::wToS(const QVector<atools::geo::Pos>& positions, QVector<QPoint>& points,
+                              QVector<bool> *visible, const QSize& size, QVector<bool> *hidden) const
+{
+  int count = positions.size();
+
+  // Split into coordinate arrays
+  QVector<double> lonX(count), latY(count), x(count), y(count);
+  for(int i = 0; i < count; i++)
+  {
+    lonX[i] = positions.at(i).getLonX();
+    latY[i] = positions.at(i).getLatY();
+  }
+
+  QVector<bool> visibleFlags(count);
+  if(hidden != nullptr)
+    hidden->resize(count);
+  int numVisible = wToS(lonX.constData(), latY.constData(), count, x.data(), y.data(), visibleFlags.data(), size,
+                        hidden != nullptr ? hidden->data() : nullptr);
+
+  points.resize(count);
+  for(int i = 0; i < count; i++)
+    points[i] = QPoint(static_cast<int>(std::round(x.at(i))), static_cast<int>(std::round(y.at(i))));
+
+  if(visible != nullptr)
+    *visible = visibleFlags;
+  return numVisible;
+}
+
+int CoordinateConverter::wToS(const double *lonX, const double *latY, int count, double *x, double *y,
+                              bool *visible, const QSize& size, bool *hidden) const
+{
+  if(count <= 0)
+    return 0;
+
+  QVector<bool> visibleFlags;
+  if(visible == nullptr)
+  {
+    visibleFlags.resize(count);
+    visible = visibleFlags.data();
+  }
+
+  switch(viewport->projection())
+  {
+    case Marble::Spherical:
+      return wToSSpherical(lonX, latY, count, x, y, visible, size, hidden);
+
+    case Marble::Mercator:
+      // Nothing is hidden in the flat projection
+      if(hidden != nullptr)
+        std::fill(hidden, hidden + count, false);
+      return wToSMercator(lonX, latY, count, x, y, visible, size);
+
+    default:
+      {
+        // Use Marble for all others
+        int numVisible = 0;
+        for(int i = 0; i < count; i++)
+        {
+          bool isHidden = false;
+          visible[i] = wToS(Marble::GeoDataCoordinates(lonX[i], latY[i], 0, DEG), x[i], y[i], size, &isHidden);
+          if(hidden != nullptr)
+            hidden[i] = isHidden;
+          numVisible += visible[i];
+        }
+        return numVisible;
+      }
+  }
+}
+
+/* Same calculation as Marble::SphericalProjection::screenCoordinates for points at zero altitude.
+ * Loops are kept free of branches to allow the compiler to vectorize them. */
+int CoordinateConverter::wToSSpherical(const double *lonX, const double *latY, int count, double *x,
+                                       double *y, bool *visible, const QSize& size, bool *hidden) const
+{
+  // Get the globe rotation as a matrix by rotating the unit vectors
+  double rot[3][3];
+  for(int col = 0; col < 3; col++)
+  {
+    Marble::Quaternion unit(0., col == 0 ? 1. : 0., col == 1 ? 1. : 0., col == 2 ? 1. : 0.);
+    unit.rotateAroundAxis(viewport->planetAxisMatrix());
+    rot[0][col] = unit.v[Marble::Q_X];
+    rot[1][col] = unit.v[Marble::Q_Y];
+    rot[2][col] = unit.v[Marble::Q_Z];
+  }
+
+  const double radius = viewport->radius();
+  const double width = viewport->width(), height = viewport->height();
+  const double halfWidth = width / 2., halfHeight = height / 2.;
+  const double halfSizeWidth = size.width() / 2., halfSizeHeight = size.height() / 2.;
+
+  // Depth coordinate to detect points behind the globe
+  QVector<double> zValues(count);
+  double *z = zValues.data();
+
+  for(int i = 0; i < count; i++)
+  {
+    double lon = lonX[i] * DEG2RAD, lat = latY[i] * DEG2RAD;
+    double cosLat = std::cos(lat);
+    double px = cosLat * std::sin(lon), py = std::sin(lat), pz = cosLat * std::cos(lon);
+
+    x[i] = halfWidth + radius * (rot[0][0] * px + rot[0][1] * py + rot[0][2] * pz);
+    y[i] = halfHeight - radius * (rot[1][0] * px + rot[1][1] * py + rot[1][2] * pz);
+    z[i] = rot[2][0] * px + rot[2][1] * py + rot[2][2] * pz;
+  }
+
+  // Marble checks the viewport bounds first and the bounds extended by half of size second
+  int numVisible = 0;
+  for(int i = 0; i < count; i++)
+  {
+    visible[i] = z[i] >= 0. && x[i] >= 0. && x[i] < width && y[i] >= 0. && y[i] < height &&
+                 x[i] + halfSizeWidth >= 0. && x[i] < width + halfSizeWidth &&
+                 y[i] + halfSizeHeight >= 0. && y[i] < height + halfSizeHeight;
+    numVisible += visible[i];
+  }
+
+  if(hidden != nullptr)
+  {
+    for(int i = 0; i < count; i++)
+      hidden[i] = z[i] < 0.;
+  }
+  return numVisible;
+}
+
+/* Same calculation as Marble::MercatorProjection::screenCoordinates including the search for the first visible
+ * horizontal repetition. Like Marble, latitudes beyond the projection limits are clamped and count as visible
+ * if the clamped point is within the size margin. Points without repetition use the strict test of the
+ * Marble fallback in wToSInternal. */
+int CoordinateConverter::wToSMercator(const double *lonX, const double *latY, int count, double *x, double *y,
+                                      bool *visible, const QSize& size) const
+{
+  // Inverse Gudermannian function
+  auto gdInv = [](double value) -> double
+               {
+                 double sinValue = std::sin(value);
+                 return 0.5 * std::log((1. + sinValue) / (1. - sinValue));
+               };
+
+  const Marble::AbstractProjection *projection = viewport->currentProjection();
+  const double minLat = projection->minLat(), maxLat = projection->maxLat();
+
+  const int radius = viewport->radius();
+  const double width = viewport->width(), height = viewport->height();
+  const double halfWidth = width / 2., halfHeight = height / 2.;
+  const double rad2Pixel = 2. * radius / M_PI;
+  const double centerLon = viewport->centerLongitude();
+  const double centerLatInv = gdInv(viewport->centerLatitude());
+  const double halfSizeWidth = size.width() / 2., halfSizeHeight = size.height() / 2.;
+  const int xRepeatDistance = 4 * radius;
+
+  int numVisible = 0;
+  for(int i = 0; i < count; i++)
+  {
+    double originalLat = latY[i] * DEG2RAD;
+    double lat = std::min(std::max(originalLat, minLat), maxLat);
+
+    double xs = halfWidth + rad2Pixel * (lonX[i] * DEG2RAD - centerLon);
+    double ys = halfHeight - rad2Pixel * (gdInv(lat) - centerLatInv);
+    y[i] = ys;
+
+    bool found = false;
+    if(0. <= ys + halfSizeHeight && ys < height + halfSizeHeight)
+    {
+      // Find the leftmost repetition of the point
+      double itX = xs;
+      if(itX + size.width() > xRepeatDistance)
+        itX -= static_cast<int>((itX + size.width()) / xRepeatDistance) * xRepeatDistance;
+
+      if(itX + halfSizeWidth < 0.)
+        itX += xRepeatDistance;
+
+      if(itX <= width + halfSizeWidth && itX - halfSizeWidth < width)
+      {
+        x[i] = itX;
+        found = true;
+      }
+    }
+
+    if(found)
+      visible[i] = true;
+    else
+    {
+      // No repetition found - use plain coordinates
+      x[i] = xs;
+      visible[i] = lat == originalLat && 0. <= ys && ys < height &&
+                   ((0. <= xs && xs < width) ||
+                    (0. <= xs - xRepeatDistance && xs - xRepeatDistance < width) ||
+                    (0. <= xs + xRepeatDistance && xs + xRepeatDistance < width));
+    }
+
+    numVisible += visible[i];
+  }
+  return numVisible;
+}
+
 bool CoordinateConverter::wToSInternal(const Marble::GeoDataCoordinates& coords, double& x, double& y,
                                        const QSize& size, bool *isHidden) const
 {
@@ -22,6 +22,7 @@
 
 #include <QPoint>
 #include <QSize>
+#include <QVector>
 
 namespace Marble {
 class ViewportParams;
@@ -103,6 +104,34 @@ public:
   bool wToS(const atools::geo::Line& coords, QLineF& line, const QSize& size = DEFAULT_WTOS_SIZE,
             bool *isHidden = nullptr) const;
 
+  /*
+   * Convert a list of world coordinates to screen coordinates in one call. Uses a direct calculation on the
+   * arrays for the spherical and Mercator projections which follows the visibility rules of the single point
+   * methods above including the size margin and the clamping of polar latitudes in Mercator.
+   * Unlike Marble, coordinates are also calculated for points hidden behind the globe.
+   * Falls back to Marble for all other projections.
+   * @param lonX input array of longitudes in degree
+   * @param latY input array of latitudes in degree
+   * @param count number of points
+   * @param x resulting screen coordinates
+   * @param y resulting screen coordinates
+   * @param visible if not null will indicate if point is visible and not hidden
+   * @param size estimated screen size of the object for the visibility check
+   * @param hidden if not null will indicate if point is hidden behind the globe
+   * @return number of visible points
+   */
+  int wToS(const double *lonX, const double *latY, int count, double *x, double *y, bool *visible = nullptr,
+           const QSize& size = DEFAULT_WTOS_SIZE, bool *hidden = nullptr) const;
+
+  /* Convert a list of positions. Points will contain rounded screen coordinates for all positions. */
+  int wToS(const QVector<atools::geo::Pos>& positions, QVector<QPoint>& points, QVector<bool> *visible = nullptr,
+           const QSize& size = DEFAULT_WTOS_SIZE, QVector<bool> *hidden = nullptr) const;
+
+  const Marble::ViewportParams *getViewport() const
+  {
+    return viewport;
+  }
+
   bool sToW(int x, int y, Marble::GeoDataCoordinates& coords) const;
 
   /* Converte screen to world coordinates */
@@ -122,6 +151,11 @@ private:
   bool wToSInternal(const Marble::GeoDataCoordinates& coords, double& x, double& y, const QSize& size,
                     bool *isHidden) const;
 
+  int wToSSpherical(const double *lonX, const double *latY, int count, double *x, double *y,
+                    bool *visible, const QSize& size, bool *hidden) const;
+  int wToSMercator(const double *lonX, const double *latY, int count, double *x, double *y,
+                   bool *visible, const QSize& size) const;
+
   const Marble::ViewportParams *viewport;
 
 };
@@ -117,7 +117,12 @@ QString formatDateLong(int timeT)
 
 QString formatElapsed(const QElapsedTimer& timer)
 {
-  int secs = static_cast<int>(timer.elapsed() / 1000L);
+  return formatElapsed(timer.elapsed());
+}
+
+QString formatElapsed(qint64 milliseconds)
+{
+  int secs = static_cast<int>(milliseconds / 1000L);
   if(secs < 60)
     return QObject::tr("%L1 %2").arg(secs).arg(secs == 1 ? QObject::tr("second") : QObject::tr("seconds"));
   else
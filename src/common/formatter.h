@@ -53,6 +53,7 @@ QString formatFloatUnit(float value, const QString& unit = QString(), int precis
 
 /* Format elapsed time to minutes and seconds */
 QString formatElapsed(const QElapsedTimer& timer);
+QString formatElapsed(qint64 milliseconds);
 
 } // namespace formatter
 
@@ -130,6 +130,14 @@ void HtmlInfoBuilder::airportTitle(const MapAirport& airport, HtmlBuilder& html,
 void HtmlInfoBuilder::airportText(const MapAirport& airport, const maptypes::WeatherContext& weatherContext,
                                   HtmlBuilder& html, const RouteMapObjectList *routeMapObjects,
                                   QColor background) const
+{
+  airportTextHead(airport, html, routeMapObjects, background);
+  airportTextWeather(weatherContext, html);
+  airportTextTail(airport, html);
+}
+
+void HtmlInfoBuilder::airportTextHead(const MapAirport& airport, HtmlBuilder& html,
+                                      const RouteMapObjectList *routeMapObjects, QColor background) const
 {
   const SqlRecord *rec = infoQuery->getAirportInformation(airport.id);
   int rating = -1;
@@ -254,7 +262,11 @@ void HtmlInfoBuilder::airportText(const MapAirport& airport, const maptypes::Wea
     html.row2(tr("Longest Runway Length:"), Unit::distShortFeet(airport.longestRunwayLength));
     html.tableEnd();
   }
+}
 
+void HtmlInfoBuilder::airportTextWeather(const maptypes::WeatherContext& weatherContext,
+                                         HtmlBuilder& html) const
+{
   if(!weatherContext.fsMetar.isEmpty() || !weatherContext.asMetar.isEmpty() ||
      !weatherContext.noaaMetar.isEmpty() || !weatherContext.vatsimMetar.isEmpty())
   {
@@ -276,6 +288,11 @@ void HtmlInfoBuilder::airportText(const MapAirport& airport, const maptypes::Wea
     addMetarLine(html, tr("VATSIM"), weatherContext.vatsimMetar);
     html.tableEnd();
   }
+}
+
+void HtmlInfoBuilder::airportTextTail(const MapAirport& airport, HtmlBuilder& html) const
+{
+  const SqlRecord *rec = infoQuery->getAirportInformation(airport.id);
 
   if(info && !airport.noRunways())
   {
@@ -111,6 +111,16 @@ public:
                    const RouteMapObjectList *routeMapObjects,
                    QColor background) const;
 
+  /*
+   * Parts of airportText() that can be built separately. Head and tail depend only on the database,
+   * the flight plan position and options while the weather part changes with each weather update.
+   */
+  void airportTextHead(const maptypes::MapAirport& airport, atools::util::HtmlBuilder& html,
+                       const RouteMapObjectList *routeMapObjects, QColor background) const;
+  void airportTextWeather(const maptypes::WeatherContext& weatherContext,
+                          atools::util::HtmlBuilder& html) const;
+  void airportTextTail(const maptypes::MapAirport& airport, atools::util::HtmlBuilder& html) const;
+
   /*
    * Creates a HTML description for all runways of an airport.
    * @param airport
@@ -92,6 +92,8 @@ const QColor highlightApproachColorFast = QColor(0, 0, 150);
 /* Flight plan line colors */
 const QColor routeOutlineColor = QColor(Qt::black);
 const QColor routeDragColor = QColor(Qt::darkYellow);
+const QColor routeAlternativeColor = QColor(Qt::darkMagenta);
+const QColor routeAlternativeSelectedColor = QColor(Qt::magenta);
 
 const QColor routeApproachOutlineColor = QColor(Qt::black);
 const QColor routeApproachColor = QColor(255, 150, 0);
@@ -892,6 +892,24 @@ bool MapSearchResult::isEmpty(const MapObjectTypes& types) const
   return !filled;
 }
 
+void MapApproachNavaids::assign(const MapSearchResult& result)
+{
+  waypoints = result.waypoints;
+  vors = result.vors;
+  ndbs = result.ndbs;
+  ils = result.ils;
+  runwayEnds = result.runwayEnds;
+}
+
+void MapApproachNavaids::toSearchResult(MapSearchResult& result) const
+{
+  result.waypoints.append(waypoints);
+  result.vors.append(vors);
+  result.ndbs.append(ndbs);
+  result.ils.append(ils);
+  result.runwayEnds.append(runwayEnds);
+}
+
 QString approachFixType(const QString& type)
 {
   return approachFixTypeToStr.value(type);
@@ -795,6 +795,39 @@ struct MapApproachRef
 
 };
 
+/* Navaids resolved for the fix of a procedure leg. Holds only the object types that can be a leg fix
+ * instead of a full search result which is copied with every leg. */
+struct MapApproachNavaids
+{
+  QList<MapWaypoint> waypoints;
+  QList<MapVor> vors;
+  QList<MapNdb> ndbs;
+  QList<MapIls> ils;
+  QList<MapRunwayEnd> runwayEnds;
+
+  /* Take over all fix types from the search result */
+  void assign(const MapSearchResult& result);
+
+  /* Append all navaids to the search result */
+  void toSearchResult(MapSearchResult& result) const;
+
+  bool hasVor() const
+  {
+    return !vors.isEmpty();
+  }
+
+  bool hasNdb() const
+  {
+    return !ndbs.isEmpty();
+  }
+
+  bool hasWaypoints() const
+  {
+    return !waypoints.isEmpty();
+  }
+
+};
+
 struct MapApproachLeg
 {
   int approachId, transitionId, legId, navId, recNavId;
@@ -821,7 +854,7 @@ struct MapApproachLeg
   MapAltRestriction altRestriction;
 
   /* Navaids resolved by approach query class */
-  MapSearchResult navaids;
+  MapApproachNavaids navaids;
 
   maptypes::ApproachLegType type = INVALID_LEG_TYPE;
   bool missed, flyover, trueCourse,
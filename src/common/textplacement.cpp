@@ -17,6 +17,7 @@
 
 #include "common/coordinateconverter.h"
 #include "common/textplacement.h"
+#include "route/routegeometry.h"
 
 #include "geo/line.h"
 #include "geo/calculations.h"
@@ -73,7 +74,17 @@ void TextPlacement::calculateTextAlongLines(const QVector<atools::geo::Line>& li
 
         int xt, yt;
         float brg;
-        if(findTextPos(lines.at(i).getPos2(), lines.at(i).getPos1(), textw, metrics.height(), xt, yt, &brg))
+        bool found;
+        if(routeGeometry != nullptr && i + 1 < routeGeometry->size())
+        {
+          // Use cached screen geometry - bearing is returned in leg direction
+          found = routeGeometry->findTextPos(i + 1, textw, metrics.height(), painter->window(), xt, yt, &brg);
+          brg = static_cast<float>(atools::geo::normalizeCourse(brg + 180.f));
+        }
+        else
+          found = findTextPos(lines.at(i).getPos2(), lines.at(i).getPos1(), textw, metrics.height(), xt, yt, &brg);
+
+        if(found)
         {
           textCoords.append(QPoint(xt, yt));
           textBearing.append(brg);
@@ -36,6 +36,7 @@ class Pos;
 
 class QPainter;
 class CoordinateConverter;
+class RouteGeometry;
 
 /* Contains methods for text placement along line strings. */
 class TextPlacement
@@ -127,6 +128,13 @@ public:
     lineWidth = value;
   }
 
+  /* Use cached screen geometry to find text positions for the first lines in calculateTextAlongLines.
+   * Line i corresponds to leg i + 1 of the route geometry. */
+  void setRouteGeometry(RouteGeometry *value)
+  {
+    routeGeometry = value;
+  }
+
   /* Set an array of colors with the same size as lines in calculateTextAlongLines */
   void setColors(const QVector<QColor>& value)
   {
@@ -152,6 +160,7 @@ private:
   bool fast = false, textOnTopOfLine = true;
   QPainter *painter = nullptr;
   CoordinateConverter *converter = nullptr;
+  RouteGeometry *routeGeometry = nullptr;
   QString arrowRight, arrowLeft;
   float lineWidth = 10.f;
   QVector<QColor> colors;
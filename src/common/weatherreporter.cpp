@@ -18,6 +18,8 @@
 #include "common/weatherreporter.h"
 
 #include "gui/mainwindow.h"
+#include "route/routecontroller.h"
+#include "route/routemapobjectlist.h"
 #include "settings/settings.h"
 #include "options/optiondata.h"
 
@@ -32,18 +34,28 @@
 #include <QTimer>
 #include <QRegularExpression>
 #include <QEventLoop>
+#include <QtConcurrent/QtConcurrentRun>
 
 // Checks the first line of an ASN file if it has valid content
 const QRegularExpression ASN_VALIDATE_REGEXP("^[A-Z0-9]{3,4}::[A-Z0-9]{3,4} .+$");
 const QRegularExpression ASN_VALIDATE_FLIGHTPLAN_REGEXP("^DepartureMETAR=.+$");
 const QRegularExpression ASN_FLIGHTPLAN_REGEXP("^(DepartureMETAR|DestinationMETAR)=([A-Z0-9]{3,4})?(.*)$");
 
+// Date line in NOAA files preceding the metar
+const QRegularExpression NOAA_DATE_REGEXP("^\\d{4}/\\d{2}/\\d{2} \\d{2}:\\d{2}$");
+// Metar line in bulk files starting with the station ident
+const QRegularExpression BULK_METAR_REGEXP("^(?:METAR |SPECI )?([A-Z0-9]{3,4}) .+$");
+
 using atools::fs::FsPaths;
 
 WeatherReporter::WeatherReporter(MainWindow *parentWindow, atools::fs::FsPaths::SimulatorType type)
   : QObject(parentWindow), noaaCache(WEATHER_TIMEOUT_SECS), vatsimCache(WEATHER_TIMEOUT_SECS), simType(type),
     mainWindow(parentWindow)
 {
+  // Notification from thread that the snapshot is loaded
+  connect(&activeSkyWatcher, &QFutureWatcher<ActiveSkySnapshot>::finished, this,
+          &WeatherReporter::activeSkySnapshotThreadFinished);
+
   initActiveSkyNext();
 
   connect(&flushQueueTimer, &QTimer::timeout, this, &WeatherReporter::flushRequestQueue);
@@ -61,6 +73,10 @@ WeatherReporter::~WeatherReporter()
   cancelVatsimReply();
 
   deleteFsWatcher();
+
+  // Wait for loading thread
+  activeSkyWatcher.disconnect();
+  activeSkyFuture.waitForFinished();
 }
 
 void WeatherReporter::flushRequestQueue()
@@ -149,7 +165,7 @@ void WeatherReporter::initActiveSkyNext()
   else
   {
     qDebug() << "Active Sky path not found";
-    activeSkyMetars.clear();
+    activeSkySnapshot = ActiveSkySnapshot();
     activeSkyDepartureMetar.clear();
     activeSkyDestinationMetar.clear();
 
@@ -158,8 +174,45 @@ void WeatherReporter::initActiveSkyNext()
   }
 }
 
-/* Loads complete ASN file into a hash map */
+/* Loads complete ASN file in background and builds an index of the metars */
 void WeatherReporter::loadActiveSkySnapshot(const QString& path)
+{
+  // TODO overrride with settings
+  if(path.isEmpty())
+    return;
+
+  if(activeSkyFuture.isRunning())
+    // Load again when the current thread is done
+    activeSkyReloadPending = true;
+  else
+  {
+    activeSkyReloadPending = false;
+
+    // Start thread - watcher will call activeSkySnapshotThreadFinished when finished
+    activeSkyFuture = QtConcurrent::run(&WeatherReporter::loadActiveSkySnapshotThread, path);
+    activeSkyWatcher.setFuture(activeSkyFuture);
+  }
+}
+
+/* Called by watcher when the thread is finished */
+void WeatherReporter::activeSkySnapshotThreadFinished()
+{
+  ActiveSkySnapshot snapshot = activeSkyFuture.result();
+
+  if(snapshot.valid)
+  {
+    // Replace the whole snapshot at once - data is implicitly shared and not copied
+    activeSkySnapshot = snapshot;
+    qDebug() << Q_FUNC_INFO << "loaded" << activeSkySnapshot.index.size() << "metars";
+  }
+
+  if(activeSkyReloadPending)
+    loadActiveSkySnapshot(asPath);
+  else
+    emit weatherUpdated();
+}
+
+WeatherReporter::ActiveSkySnapshot WeatherReporter::loadActiveSkySnapshotThread(QString path)
 {
   // ASN
   // C:\Users\USER\AppData\Roaming\HiFi\ASNFSX\Weather\current_wx_snapshot.txt or wx_station_list.txt
@@ -170,35 +223,62 @@ void WeatherReporter::loadActiveSkySnapshot(const QString& path)
   // 34010KT 9999 -SH SCT019 SCT03 FM271200 VRB03KT 9999 -SH FEW017 SCT028 PROB30 INTER 2703/27010 5000 TSSH SCT016 FEW017CB BKN028
   // T 25 27 31 32 Q 1009 1011 1011 1009::278,11,24.0/267,12,19.0/263,13,16.1/233,12,7.2/290,7,-3.0/338,8,-13.0/348,18,-27.9/9,19,-37.9/26,15,-51.3
 
-  // TODO overrride with settings
-  if(path.isEmpty())
-    return;
+  ActiveSkySnapshot snapshot;
 
+  // Read the file at once and close it immediately to avoid blocking Active Sky when writing
   QFile file(path);
-  if(file.open(QIODevice::ReadOnly | QIODevice::Text))
+  if(file.open(QIODevice::ReadOnly))
   {
-    activeSkyMetars.clear();
+    snapshot.data = file.readAll();
+    file.close();
+    snapshot.valid = true;
+  }
+  else
+  {
+    qWarning() << "cannot open" << file.fileName() << "reason" << file.errorString();
+    return snapshot;
+  }
 
-    QTextStream weatherSnapshot(&file);
+  const QByteArray& data = snapshot.data;
+  const int size = data.size();
+  int lineStart = 0, lineNum = 1;
 
-    int lineNum = 1;
-    QString line;
-    while(weatherSnapshot.readLineInto(&line))
+  while(lineStart < size)
+  {
+    int lineEnd = data.indexOf('\n', lineStart);
+    if(lineEnd == -1)
+      lineEnd = size;
+
+    // Ignore windows line endings
+    int lineLen = lineEnd - lineStart;
+    if(lineLen > 0 && data.at(lineEnd - 1) == '\r')
+      lineLen--;
+
+    if(lineLen > 0)
     {
-      QStringList list = line.split("::");
-      if(list.size() >= 2)
-        activeSkyMetars.insert(list.at(0), list.at(1));
+      // Find ident and metar separators within the current line
+      int identSep = data.indexOf("::", lineStart);
+      if(identSep != -1 && identSep + 2 <= lineStart + lineLen)
+      {
+        int metarStart = identSep + 2;
+        int metarEnd = data.indexOf("::", metarStart);
+        if(metarEnd == -1 || metarEnd > lineStart + lineLen)
+          metarEnd = lineStart + lineLen;
+
+        snapshot.index.insert(data.mid(lineStart, identSep - lineStart),
+                              qMakePair(metarStart, metarEnd - metarStart));
+      }
       else
       {
-        qWarning() << "AS file" << file.fileName() << "has invalid entries";
-        qWarning() << "line #" << lineNum << line;
+        qWarning() << "AS file" << path << "has invalid entries";
+        qWarning() << "line #" << lineNum << data.mid(lineStart, lineLen);
       }
-      lineNum++;
     }
-    file.close();
+    lineStart = lineEnd + 1;
+    lineNum++;
   }
-  else
-    qWarning() << "cannot open" << file.fileName() << "reason" << file.errorString();
+
+  return snapshot;
 }
 
 /* Loads flight plan weather for start and destination */
@@ -367,7 +447,8 @@ void WeatherReporter::loadVatsimMetar(const QString& airportIcao)
     cancelVatsimReply();
 
     vatsimRequestIcao = airportIcao;
-    QNetworkRequest request(QUrl(OptionData::instance().getWeatherVatsimUrl().arg(airportIcao)));
+    const QString& url = OptionData::instance().getWeatherVatsimUrl();
+    QNetworkRequest request(QUrl(isBulkUrl(url) ? url : url.arg(airportIcao)));
 
     vatsimReply = networkManager.get(request);
 
@@ -427,7 +508,8 @@ void WeatherReporter::loadNoaaMetar(const QString& airportIcao)
     cancelNoaaReply();
 
     noaaRequestIcao = airportIcao;
-    QNetworkRequest request(QUrl(OptionData::instance().getWeatherNoaaUrl().arg(airportIcao)));
+    const QString& url = OptionData::instance().getWeatherNoaaUrl();
+    QNetworkRequest request(QUrl(isBulkUrl(url) ? url : url.arg(airportIcao)));
 
     noaaReply = networkManager.get(request);
 
@@ -442,11 +524,15 @@ void WeatherReporter::loadNoaaMetar(const QString& airportIcao)
 void WeatherReporter::httpFinishedNoaa()
 {
   // qDebug() << Q_FUNC_INFO << noaaRequestIcao;
-  httpFinished(noaaReply, noaaRequestIcao, noaaCache);
+  bool bulk = isBulkUrl(OptionData::instance().getWeatherNoaaUrl());
+  bool updated = httpFinished(noaaReply, noaaRequestIcao, bulk, noaaCache);
   if(noaaReply != nullptr)
     noaaReply->deleteLater();
   noaaReply = nullptr;
 
+  if(requestFinished(noaaRequestIcao, bulk, updated, noaaUpdated, noaaRequests, noaaInteractiveIcaos, noaaCache))
+    emit weatherUpdated();
+
   if(!noaaRequests.isEmpty())
     loadNoaaMetar(noaaRequests.takeLast());
 }
@@ -455,31 +541,83 @@ void WeatherReporter::httpFinishedNoaa()
 void WeatherReporter::httpFinishedVatsim()
 {
   // qDebug() << Q_FUNC_INFO << vatsimRequestIcao;
-  httpFinished(vatsimReply, vatsimRequestIcao, vatsimCache);
+  bool bulk = isBulkUrl(OptionData::instance().getWeatherVatsimUrl());
+  bool updated = httpFinished(vatsimReply, vatsimRequestIcao, bulk, vatsimCache);
   if(vatsimReply != nullptr)
     vatsimReply->deleteLater();
   vatsimReply = nullptr;
 
+  if(requestFinished(vatsimRequestIcao, bulk, updated, vatsimUpdated, vatsimRequests, vatsimInteractiveIcaos,
+                     vatsimCache))
+    emit weatherUpdated();
+
   if(!vatsimRequests.isEmpty())
     loadVatsimMetar(vatsimRequests.takeLast());
 }
 
-void WeatherReporter::httpFinished(QNetworkReply *reply, const QString& icao,
+bool WeatherReporter::requestFinished(const QString& icao, bool bulk, bool updated, bool& queueUpdated,
+                                      QStringList& requests, QSet<QString>& interactiveIcaos,
+                                      atools::util::TimedCache<QString, QString>& metars)
+{
+  bool interactive = interactiveIcaos.remove(icao);
+
+  if(bulk)
+  {
+    // All stations are covered by the bulk reply
+    if(updated)
+    {
+      // Remember stations that are not in the file to avoid downloading it again
+      for(const QString& request : requests)
+      {
+        if(metars.value(request) == nullptr)
+          metars.insert(request, QString());
+      }
+    }
+
+    interactive |= !interactiveIcaos.isEmpty();
+    interactiveIcaos.clear();
+    requests.clear();
+  }
+
+  queueUpdated |= updated;
+
+  // Send update immediately for stations requested by the user and only once for prefetched stations
+  if(queueUpdated && (interactive || requests.isEmpty()))
+  {
+    queueUpdated = false;
+    return true;
+  }
+  return false;
+}
+
+bool WeatherReporter::httpFinished(QNetworkReply *reply, const QString& icao, bool bulk,
                                    atools::util::TimedCache<QString, QString>& metars)
 {
+  bool updated = false;
   if(reply != nullptr)
   {
     if(reply->error() == QNetworkReply::NoError)
     {
-      QString metar = reply->readAll().simplified();
-      if(!metar.contains("no metar available", Qt::CaseInsensitive))
-        // Add metar with current time
-        metars.insert(icao, metar);
+      if(bulk)
+      {
+        insertBulkMetars(QString(reply->readAll()), metars);
+
+        if(metars.value(icao) == nullptr)
+          // Add empty record so we know there is no weather station
+          metars.insert(icao, QString());
+      }
       else
-        // Add empty record so we know there is no weather station
-        metars.insert(icao, QString());
+      {
+        QString metar = reply->readAll().simplified();
+        if(!metar.contains("no metar available", Qt::CaseInsensitive))
+          // Add metar with current time
+          metars.insert(icao, metar);
+        else
+          // Add empty record so we know there is no weather station
+          metars.insert(icao, QString());
+      }
       // mainWindow->setStatusMessage(tr("Weather information updated."));
-      emit weatherUpdated();
+      updated = true;
     }
     else if(reply->error() != QNetworkReply::OperationCanceledError)
     {
@@ -491,6 +629,91 @@ void WeatherReporter::httpFinished(QNetworkReply *reply, const QString& icao,
     }
     reply->deleteLater();
   }
+  return updated;
+}
+
+void WeatherReporter::insertBulkMetars(const QString& text,
+                                       atools::util::TimedCache<QString, QString>& metars)
+{
+  // NOAA cycle files contain a date line before each metar:
+  // 2017/03/05 12:00
+  // EDDF 051220Z 24012KT 9999 FEW030 08/02 Q1012 NOSIG
+  QString date;
+  int num = 0;
+  for(const QString& line : text.split('\n'))
+  {
+    QString str = line.simplified();
+    if(str.isEmpty())
+      continue;
+
+    if(NOAA_DATE_REGEXP.match(str).hasMatch())
+      date = str;
+    else
+    {
+      QRegularExpressionMatch match = BULK_METAR_REGEXP.match(str);
+      if(match.hasMatch())
+      {
+        // Use the same format as single station requests
+        metars.insert(match.captured(1), date.isEmpty() ? str : date + " " + str);
+        num++;
+      }
+      date.clear();
+    }
+  }
+  qDebug() << Q_FUNC_INFO << "loaded" << num << "metars";
+}
+
+bool WeatherReporter::isBulkUrl(const QString& url)
+{
+  return !url.contains("%1");
+}
+
+void WeatherReporter::prefetchMetars(const QStringList& airportIcaos)
+{
+  opts::Flags flags = OptionData::instance().getFlags();
+
+  if(flags & opts::WEATHER_INFO_NOAA || flags & opts::WEATHER_TOOLTIP_NOAA)
+  {
+    prefetchMetars(airportIcaos, noaaCache, noaaRequests, noaaRequestIcao);
+    if(noaaReply == nullptr && !noaaRequests.isEmpty())
+      loadNoaaMetar(noaaRequests.takeLast());
+  }
+
+  if(flags & opts::WEATHER_INFO_VATSIM || flags & opts::WEATHER_TOOLTIP_VATSIM)
+  {
+    prefetchMetars(airportIcaos, vatsimCache, vatsimRequests, vatsimRequestIcao);
+    if(vatsimReply == nullptr && !vatsimRequests.isEmpty())
+      loadVatsimMetar(vatsimRequests.takeLast());
+  }
+}
+
+/* Add all airports that are neither cached nor requested to the request queue */
+void WeatherReporter::prefetchMetars(const QStringList& airportIcaos,
+                                     atools::util::TimedCache<QString, QString>& metars,
+                                     QStringList& requests, const QString& requestIcao)
+{
+  for(const QString& icao : airportIcaos)
+  {
+    if(!icao.isEmpty() && icao != requestIcao && metars.value(icao) == nullptr && !requests.contains(icao))
+      // Queue is processed from the end - put prefetched airports in front of user requests
+      requests.prepend(icao);
+  }
+}
+
+void WeatherReporter::routeChanged(bool geometryChanged)
+{
+  if(!geometryChanged)
+    return;
+
+  QStringList idents;
+  for(const RouteMapObject& rmo : mainWindow->getRouteController()->getRouteMapObjects())
+  {
+    if(rmo.getMapObjectType() == maptypes::AIRPORT)
+      idents.append(rmo.getIdent());
+  }
+
+  if(!idents.isEmpty())
+    prefetchMetars(idents);
 }
 
 QString WeatherReporter::getActiveSkyMetar(const QString& airportIcao)
@@ -500,7 +723,14 @@ QString WeatherReporter::getActiveSkyMetar(const QString& airportIcao)
   else if(activeSkyDestinationIdent == airportIcao)
     return activeSkyDestinationMetar;
   else
-    return activeSkyMetars.value(airportIcao, QString());
+  {
+    // Decode only the requested metar
+    QHash<QByteArray, QPair<int, int> >::const_iterator it = activeSkySnapshot.index.constFind(
+      airportIcao.toLatin1());
+    if(it != activeSkySnapshot.index.constEnd())
+      return QString::fromLatin1(activeSkySnapshot.data.constData() + it.value().first, it.value().second);
+  }
+  return QString();
 }
 
 QString WeatherReporter::getNoaaMetar(const QString& airportIcao)
@@ -511,7 +741,10 @@ QString WeatherReporter::getNoaaMetar(const QString& airportIcao)
   if(metar != nullptr)
     return QString(*metar);
   else
+  {
+    noaaInteractiveIcaos.insert(airportIcao);
     loadNoaaMetar(airportIcao);
+  }
 
   return QString();
 }
@@ -524,7 +757,10 @@ QString WeatherReporter::getVatsimMetar(const QString& airportIcao)
   if(metar != nullptr)
     return QString(*metar);
   else
+  {
+    vatsimInteractiveIcaos.insert(airportIcao);
     loadVatsimMetar(airportIcao);
+  }
 
   return QString();
 }
@@ -553,9 +789,8 @@ void WeatherReporter::activeSkyWeatherFileChanged(const QString& path)
 {
   Q_UNUSED(path);
   qDebug() << Q_FUNC_INFO << "file" << path << "changed";
-  loadActiveSkySnapshot(asPath);
+  // Flight plan file is small and loaded directly - weatherUpdated is sent once the snapshot thread is done
   loadActiveSkyFlightplanSnapshot(asFlightplanPath);
+  loadActiveSkySnapshot(asPath);
   mainWindow->setStatusMessage(tr("Active Sky weather information updated."));
-
-  emit weatherUpdated();
 }
@@ -21,9 +21,12 @@
 #include "fs/fspaths.h"
 #include "util/timedcache.h"
 
+#include <QFuture>
+#include <QFutureWatcher>
 #include <QHash>
 #include <QNetworkAccessManager>
 #include <QObject>
+#include <QSet>
 #include <QTimer>
 
 class QFileSystemWatcher;
@@ -37,7 +40,13 @@ class MainWindow;
  *
  * Uses hashmaps to cache online requests. Cache entries will timeout after 15 minutes.
  *
- * Only one request is done. If a request is already waiting a new one will cancel the old one.
+ * The Active Sky snapshot file is read and indexed in a background thread. Metars are kept as raw bytes
+ * and only decoded when requested.
+ *
+ * Only one request is done at a time. Requests arriving while another one is running are queued.
+ *
+ * A weather URL without the %1 placeholder is considered a bulk source (e.g. a local file or server
+ * providing a NOAA cycle file) which returns all metars in one request. All stations are added to the cache.
  */
 // TODO better support for mutliple simulators
 class WeatherReporter :
@@ -67,6 +76,16 @@ public:
    */
   QString getVatsimMetar(const QString& airportIcao);
 
+  /*
+   * Request NOAA and VATSIM metars for all given airports in one pass. Only stations which are neither cached
+   * nor already queued are requested. weatherUpdated is emitted once when all requests are done.
+   * Sources are selected by the info and tooltip weather options.
+   */
+  void prefetchMetars(const QStringList& airportIcaos);
+
+  /* Flight plan has changed. Prefetches weather for all airports in the plan. */
+  void routeChanged(bool geometryChanged);
+
   /* Does nothing currently */
   void preDatabaseLoad();
 
@@ -125,9 +144,22 @@ private:
   // Update online reports if older than 10 minutes
   static Q_CONSTEXPR int WEATHER_TIMEOUT_SECS = 600;
 
+  /* Raw content of an Active Sky snapshot file and position of the metars in it */
+  struct ActiveSkySnapshot
+  {
+    QByteArray data;
+    QHash<QByteArray, QPair<int, int> > index; /* Station ident to metar offset and length in data */
+    bool valid = false; /* false if file could not be read */
+  };
+
   void activeSkyWeatherFileChanged(const QString& path);
 
+  /* Starts the background thread to load the snapshot or queues a reload if the thread is already running */
   void loadActiveSkySnapshot(const QString& path);
+  void activeSkySnapshotThreadFinished();
+
+  /* Reads the file and builds the index. Runs in a background thread. */
+  static ActiveSkySnapshot loadActiveSkySnapshotThread(QString path);
   void loadActiveSkyFlightplanSnapshot(const QString& path);
   void initActiveSkyNext();
   void findActiveSkyFiles(QString& asnSnapshot, QString& flightplanSnapshot, const QString& activeSkyPrefix);
@@ -135,11 +167,24 @@ private:
   void loadNoaaMetar(const QString& airportIcao);
   void loadVatsimMetar(const QString& airportIcao);
 
-  void httpFinished(QNetworkReply *reply, const QString& icao,
+  /* @return true if the cache was updated */
+  bool httpFinished(QNetworkReply *reply, const QString& icao, bool bulk,
                     atools::util::TimedCache<QString, QString>& metars);
+
+  /* Add all metars of a bulk reply to the cache */
+  void insertBulkMetars(const QString& text, atools::util::TimedCache<QString, QString>& metars);
+  static bool isBulkUrl(const QString& url);
+  static void prefetchMetars(const QStringList& airportIcaos, atools::util::TimedCache<QString, QString>& metars,
+                             QStringList& requests, const QString& requestIcao);
   void httpFinishedNoaa();
   void httpFinishedVatsim();
 
+  /* Update the request queue after a reply. Stations missing in a bulk reply are added as empty.
+   * @return true if weatherUpdated should be emitted */
+  static bool requestFinished(const QString& icao, bool bulk, bool updated, bool& queueUpdated,
+                              QStringList& requests, QSet<QString>& interactiveIcaos,
+                              atools::util::TimedCache<QString, QString>& metars);
+
   void cancelNoaaReply();
   void cancelVatsimReply();
   void flushRequestQueue();
@@ -147,7 +192,14 @@ private:
   void deleteFsWatcher();
   void createFsWatcher();
 
-  QHash<QString, QString> activeSkyMetars;
+  ActiveSkySnapshot activeSkySnapshot;
+
+  /* Used to fetch the snapshot from the thread */
+  QFuture<ActiveSkySnapshot> activeSkyFuture;
+  /* Sends signal once thread is finished */
+  QFutureWatcher<ActiveSkySnapshot> activeSkyWatcher;
+  /* File changed while thread was running - load again once finished */
+  bool activeSkyReloadPending = false;
   QString activeSkyDepartureMetar, activeSkyDestinationMetar,
           activeSkyDepartureIdent, activeSkyDestinationIdent;
 
@@ -165,6 +217,12 @@ private:
   QNetworkReply *noaaReply = nullptr, *vatsimReply = nullptr;
   QStringList noaaRequests, vatsimRequests;
 
+  // Set if any reply of the current request queue changed the cache
+  bool noaaUpdated = false, vatsimUpdated = false;
+
+  // Stations requested by getNoaaMetar or getVatsimMetar. Updates for these are sent without waiting for the queue.
+  QSet<QString> noaaInteractiveIcaos, vatsimInteractiveIcaos;
+
   MainWindow *mainWindow;
   QTimer flushQueueTimer;
 
@@ -31,6 +31,7 @@
 #include "sql/sqlutil.h"
 #include "gui/errorhandler.h"
 #include "gui/mainwindow.h"
+#include "common/approachquery.h"
 
 #include <QDebug>
 #include <QElapsedTimer>
@@ -45,6 +46,8 @@
 #include <QAbstractButton>
 #include <QSettings>
 #include <QSplashScreen>
+#include <QMutexLocker>
+#include <QtConcurrent/QtConcurrentRun>
 
 using atools::gui::ErrorHandler;
 using atools::sql::SqlUtil;
@@ -120,6 +123,15 @@ const QString DATABASE_LOADING_TEXT(QObject::tr(
                                       "<big>Found:</big></br>"
                                       ) + DATABASE_INFO_TEXT);
 
+const QString DATABASE_THROUGHPUT_TEXT(QObject::tr("<br/><b>Throughput:</b> %L1 files per second"));
+const QString DATABASE_STAGE_TEXT(QObject::tr("<br/><b>%1:</b> %2"));
+
+/* Stage name used for reading the BGL files before the first script or other action */
+const QString DATABASE_STAGE_READING(QObject::tr("Reading scenery"));
+
+/* Stage name for the optional procedure calculation after loading */
+const QString DATABASE_STAGE_PROCEDURES(QObject::tr("Calculating procedures"));
+
 DatabaseManager::DatabaseManager(MainWindow *parent)
   : QObject(parent), mainWindow(parent)
 {
@@ -159,6 +171,14 @@ DatabaseManager::DatabaseManager(MainWindow *parent)
             &DatabaseManager::simulatorChangedFromComboBox);
   }
 
+  // Notification from thread that the scenery library is loaded
+  connect(&loadingWatcher, &QFutureWatcher<LoadingResult>::finished, this,
+          &DatabaseManager::loadSceneryThreadFinished);
+
+  // Update progress window four times a second while loading
+  progressTimer.setInterval(250);
+  connect(&progressTimer, &QTimer::timeout, this, &DatabaseManager::updateProgressDialog);
+
   if(!SqlDatabase::contains(DATABASE_NAME))
     // Add database driver if not already done
     db = new SqlDatabase(SqlDatabase::addDatabase(DATABASE_TYPE, DATABASE_NAME));
@@ -166,6 +186,18 @@ DatabaseManager::DatabaseManager(MainWindow *parent)
 
 DatabaseManager::~DatabaseManager()
 {
+  // Stop loading thread and remove the incomplete database file
+  progressTimer.stop();
+  loadingWatcher.disconnect();
+  if(loadingFuture.isRunning())
+  {
+    loadingCanceled = true;
+    loadingFuture.waitForFinished();
+    QFile::remove(loadingDatabaseFile);
+  }
+  delete loadingOptions;
+  delete loadingErrors;
+
   // Delete simulator switch actions
   freeActions();
 
@@ -377,11 +409,24 @@ void DatabaseManager::switchSimFromMainMenu()
   }
 }
 
-void DatabaseManager::openDatabase()
+/* Pragmas used for the main database and the one filled by the loading thread */
+QStringList DatabaseManager::databasePragmas() const
 {
   // cache_size * 1024 bytes if value is negative
   QStringList pragmas({"PRAGMA cache_size=-50000", "PRAGMA synchronous=OFF", "PRAGMA journal_mode=TRUNCATE",
                        "PRAGMA page_size=8196"});
+
+  // Set foreign keys only on demand because they can decrease loading performance
+  if(Settings::instance().getAndStoreValue(lnm::OPTIONS_FOREIGNKEYS, false).toBool())
+    pragmas.append("PRAGMA foreign_keys = ON");
+  else
+    pragmas.append("PRAGMA foreign_keys = OFF");
+  return pragmas;
+}
+
+void DatabaseManager::openDatabase()
+{
+  QStringList pragmas = databasePragmas();
   QStringList pragmaQueries({"PRAGMA foreign_keys", "PRAGMA cache_size", "PRAGMA synchronous",
                              "PRAGMA journal_mode", "PRAGMA page_size"});
 
@@ -390,12 +435,6 @@ void DatabaseManager::openDatabase()
     qDebug() << "Opening database" << databaseFile;
     db->setDatabaseName(databaseFile);
 
-    // Set foreign keys only on demand because they can decrease loading performance
-    if(Settings::instance().getAndStoreValue(lnm::OPTIONS_FOREIGNKEYS, false).toBool())
-      pragmas.append("PRAGMA foreign_keys = ON");
-    else
-      pragmas.append("PRAGMA foreign_keys = OFF");
-
     bool autocommit = db->isAutocommit();
     db->setAutocommit(false);
     db->open(pragmas);
@@ -461,35 +500,31 @@ atools::sql::SqlDatabase *DatabaseManager::getDatabase()
 
 void DatabaseManager::run()
 {
+  if(isLoadingScenery())
+  {
+    // Already loading in background - bring progress window to front
+    progressDialog->show();
+    progressDialog->raise();
+    progressDialog->activateWindow();
+    return;
+  }
+
   if(simulators.contains(currentFsType) && simulators.value(currentFsType).hasRegistry)
     // Use what is currently displayed on the map
     loadingFsType = currentFsType;
 
-  // Disconnect all queries
-  emit preDatabaseLoad();
-
-  closeDatabase();
-  databaseFile = buildDatabaseFileName(loadingFsType);
-  openDatabase();
-
+  // The current database is left open and keeps serving map, search and routing
   databaseDialog->setCurrentFsType(loadingFsType);
 
   updateDialogInfo();
 
-  // try until user hits cancel or the database was loaded successfully
+  // try until user hits cancel or the database loading was started successfully
   while(runInternal())
     ;
-
-  closeDatabase();
-  databaseFile = buildDatabaseFileName(currentFsType);
-  openDatabase();
-
-  // Reconnect all queries
-  emit postDatabaseLoad(currentFsType);
 }
 
 /* Shows scenery database loading dialog.
- * @return true if execution was successfull. false if it was cancelled */
+ * @return true if dialog should be shown again because of an error. */
 bool DatabaseManager::runInternal()
 {
   bool reopenDialog = true;
@@ -511,17 +546,9 @@ bool DatabaseManager::runInternal()
       {
         if(atools::fs::NavDatabase::isSceneryConfigValid(databaseDialog->getSceneryConfigFile(), err))
         {
-          if(loadScenery())
-          {
-            // Successfully loaded
-            DatabaseMeta dbmeta(db);
-            dbmeta.updateAll();
-            reopenDialog = false;
-
-            // Syncronize display with loaded database
-            currentFsType = loadingFsType;
-            updateSimSwitchActions();
-          }
+          // Start loading thread - loadSceneryThreadFinished will switch to the new database
+          loadScenery();
+          reopenDialog = false;
         }
         else
           QMessageBox::warning(databaseDialog, QApplication::applicationName(),
@@ -547,29 +574,53 @@ bool DatabaseManager::runInternal()
   return reopenDialog;
 }
 
-/* Opens progress dialog and loads scenery
- * @return true if loading was successfull. false if cancelled or an error occured */
-bool DatabaseManager::loadScenery()
+/* Opens the non-modal progress window and starts loading the scenery into a new database file
+ * in a background thread. */
+void DatabaseManager::loadScenery()
 {
   using atools::fs::NavDatabaseOptions;
 
-  bool success = true;
   // Get configuration file path from resources or overloaded path
   QString config = Settings::getOverloadedPath(lnm::DATABASE_NAVDATAREADER_CONFIG);
   qInfo() << "loadScenery: Config file" << config;
 
   QSettings settings(config, QSettings::IniFormat);
 
-  NavDatabaseOptions bglReaderOpts;
-  bglReaderOpts.loadFromSettings(settings);
+  delete loadingOptions;
+  loadingOptions = new NavDatabaseOptions;
+  loadingOptions->loadFromSettings(settings);
 
   // Add exclude paths from option dialog
   const OptionData& optionData = OptionData::instance();
-  bglReaderOpts.addToAddonDirectoryExcludes(optionData.getDatabaseAddonExclude());
-  bglReaderOpts.addToDirectoryExcludes(optionData.getDatabaseExclude());
+  loadingOptions->addToAddonDirectoryExcludes(optionData.getDatabaseAddonExclude());
+  loadingOptions->addToDirectoryExcludes(optionData.getDatabaseExclude());
+
+  loadingOptions->setSceneryFile(simulators.value(loadingFsType).sceneryCfg);
+  loadingOptions->setBasepath(simulators.value(loadingFsType).basePath);
+
+  delete loadingErrors;
+  loadingErrors = new atools::fs::NavDatabaseErrors;
+
+  // Remove any leftovers from an aborted loading process
+  loadingDatabaseFile = buildDatabaseFileName(loadingFsType) + lnm::DATABASE_LOADING_SUFFIX;
+  if(QFile::exists(loadingDatabaseFile))
+  {
+    bool removed = QFile::remove(loadingDatabaseFile);
+    qDebug() << "removed stale database" << loadingDatabaseFile << removed;
+  }
+
+  // Settings cannot be read in the loading thread
+  loadingProcedureGeometry =
+    Settings::instance().getAndStoreValue(lnm::OPTIONS_PROCEDURE_GEOMETRY, true).toBool();
+
+  loadingCanceled = false;
+  {
+    QMutexLocker locker(&progressMutex);
+    loadingProgress = LoadingProgress();
+  }
 
   delete progressDialog;
-  progressDialog = new QProgressDialog(databaseDialog);
+  progressDialog = new QProgressDialog(mainWindow);
   progressDialog->setWindowFlags(progressDialog->windowFlags() & ~Qt::WindowContextHelpButtonHint);
 
   progressDialog->setWindowTitle(tr("%1 - Loading %2").
@@ -583,58 +634,208 @@ bool DatabaseManager::loadScenery()
   label->setTextInteractionFlags(Qt::TextSelectableByMouse);
   label->setMinimumWidth(800);
 
-  progressDialog->setWindowModality(Qt::WindowModal);
+  // Do not block the main window - program can be used while loading
+  progressDialog->setWindowModality(Qt::NonModal);
   progressDialog->setLabel(label);
   progressDialog->setAutoClose(false);
   progressDialog->setAutoReset(false);
   progressDialog->setMinimumDuration(0);
 
-  bglReaderOpts.setSceneryFile(simulators.value(loadingFsType).sceneryCfg);
-  bglReaderOpts.setBasepath(simulators.value(loadingFsType).basePath);
-
-  QElapsedTimer timer;
-  progressTimerElapsed = 0L;
-
   progressDialog->setLabelText(
     DATABASE_TIME_TEXT.arg(QString()).
     arg(QString()).
     arg(QString()).arg(QString()).arg(0).arg(0).arg(0).arg(0).arg(0).arg(0).arg(0).arg(0));
 
+  connect(progressDialog, &QProgressDialog::canceled, this, &DatabaseManager::progressDialogCanceled);
   progressDialog->show();
 
-  bglReaderOpts.setProgressCallback(std::bind(&DatabaseManager::progressCallback, this,
-                                              std::placeholders::_1, timer));
+  loadingTimer.start();
+  progressTimer.start();
 
-  // Let the dialog close and show the busy pointer
-  QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-  atools::fs::NavDatabaseErrors errors;
+  mainWindow->setStatusMessage(tr("Loading scenery library for %1 in background.").
+                               arg(FsPaths::typeToName(loadingFsType)));
 
-  try
+  // Start thread - watcher will call loadSceneryThreadFinished when finished
+  loadingFuture = QtConcurrent::run(this, &DatabaseManager::loadSceneryThread, databasePragmas());
+  loadingWatcher.setFuture(loadingFuture);
+}
+
+/* Runs in a background thread and fills the new database file. Must not access any GUI elements. */
+DatabaseManager::LoadingResult DatabaseManager::loadSceneryThread(QStringList pragmas)
+{
+  LoadingResult result;
+  QElapsedTimer timer;
+
+  loadingOptions->setProgressCallback(std::bind(&DatabaseManager::progressCallback, this,
+                                                std::placeholders::_1, timer));
+
+  // Need empty block to delete loadingDb before removing driver
   {
-    // Create a backup of the database and delete the original file
-    backupDatabaseFile();
+    // A database connection can only be used in the thread that created it
+    SqlDatabase loadingDb = SqlDatabase::addDatabase(DATABASE_TYPE, DATABASE_NAME_LOADING);
+    try
+    {
+      qDebug() << "Loading into database" << loadingDatabaseFile;
+      loadingDb.setDatabaseName(loadingDatabaseFile);
+
+      bool autocommit = loadingDb.isAutocommit();
+      loadingDb.setAutocommit(false);
+      loadingDb.open(pragmas);
+      loadingDb.setAutocommit(autocommit);
+
+      atools::fs::NavDatabase nd(loadingOptions, &loadingDb, loadingErrors);
+      nd.create();
+
+      if(!loadingCanceled && loadingProcedureGeometry)
+      {
+        // Calculate all procedure legs once so they can be loaded without processing
+        {
+          // Show as other action until done
+          QMutexLocker locker(&progressMutex);
+          loadingProgress.currentStage = loadingProgress.otherAction = DATABASE_STAGE_PROCEDURES;
+          loadingProgress.isOther = true;
+          loadingProgress.isLast = false;
+        }
+
+        QElapsedTimer stageTimer;
+        stageTimer.start();
+        ApproachQuery::createProcedureGeometry(&loadingDb, loadingDatabaseFile, loadingCanceled);
+
+        {
+          QMutexLocker locker(&progressMutex);
+          loadingProgress.stageTimes.append(qMakePair(DATABASE_STAGE_PROCEDURES, stageTimer.elapsed()));
+          loadingProgress.currentStage.clear();
+          loadingProgress.isLast = true;
+        }
+      }
 
-    atools::fs::NavDatabase nd(&bglReaderOpts, db, &errors);
-    nd.create();
+      if(!loadingCanceled)
+      {
+        DatabaseMeta(&loadingDb).updateAll();
+        result.success = true;
+      }
+
+      loadingDb.close();
+    }
+    catch(...)
+    {
+      // Rethrown and shown in the main thread
+      result.exception = std::current_exception();
+    }
   }
-  catch(atools::Exception& e)
+  SqlDatabase::removeDatabase(DATABASE_NAME_LOADING);
+
+  result.canceled = loadingCanceled;
+  return result;
+}
+
+/* Called by watcher when the thread is finished. Replaces the database file if loading was successful. */
+void DatabaseManager::loadSceneryThreadFinished()
+{
+  LoadingResult result = loadingFuture.result();
+  progressTimer.stop();
+
+  // Show final numbers
+  updateProgressDialog();
+
+  QString bglFilePath;
   {
-    // Show dialog if something went wrong
-    ErrorHandler(databaseDialog).handleException(
-      e, currentBglFilePath.isEmpty() ? QString() : tr("Processed BGL file:\n%1\n").arg(currentBglFilePath));
-    success = false;
+    QMutexLocker locker(&progressMutex);
+    bglFilePath = loadingProgress.bglFilePath;
   }
-  catch(...)
+
+  if(result.exception)
   {
+    progressDialog->hide();
+
     // Show dialog if something went wrong
-    ErrorHandler(databaseDialog).handleUnknownException(
-      currentBglFilePath.isEmpty() ? QString() : tr("Processed BGL file:\n%1\n").arg(currentBglFilePath));
-    success = false;
+    QString msg = bglFilePath.isEmpty() ? QString() : tr("Processed BGL file:\n%1\n").arg(bglFilePath);
+    try
+    {
+      std::rethrow_exception(result.exception);
+    }
+    catch(atools::Exception& e)
+    {
+      ErrorHandler(mainWindow).handleException(e, msg);
+    }
+    catch(...)
+    {
+      ErrorHandler(mainWindow).handleUnknownException(msg);
+    }
   }
 
-  QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-
   // Show errors that occured during loading, if any
+  showLoadingErrors();
+
+  bool success = result.success && !result.canceled;
+  if(success)
+  {
+    // Disconnect all queries
+    emit preDatabaseLoad();
+
+    closeDatabase();
+
+    QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+    success = swapDatabaseFile(loadingDatabaseFile, buildDatabaseFileName(loadingFsType));
+    QGuiApplication::restoreOverrideCursor();
+
+    if(success)
+    {
+      // Syncronize display with loaded database
+      currentFsType = loadingFsType;
+      simulators[currentFsType].hasDatabase = true;
+      updateSimSwitchActions();
+    }
+
+    databaseFile = buildDatabaseFileName(currentFsType);
+    openDatabase();
+
+    // Reconnect all queries
+    emit postDatabaseLoad(currentFsType);
+  }
+
+  if(success)
+  {
+    // Leave results on screen until user selects ok
+    progressDialog->setCancelButtonText(tr("&OK"));
+    mainWindow->setStatusMessage(tr("Scenery library for %1 loaded.").arg(FsPaths::typeToName(currentFsType)));
+  }
+  else
+  {
+    progressDialog->hide();
+
+    bool removed = QFile::remove(loadingDatabaseFile);
+    qDebug() << "removed incomplete database" << loadingDatabaseFile << removed;
+
+    if(result.canceled)
+      mainWindow->setStatusMessage(tr("Loading of scenery library canceled."));
+    else
+      mainWindow->setStatusMessage(tr("Loading of scenery library failed."));
+  }
+
+  delete loadingOptions;
+  loadingOptions = nullptr;
+  delete loadingErrors;
+  loadingErrors = nullptr;
+}
+
+/* Progress window cancel button or close - will also be called when clicking OK after loading */
+void DatabaseManager::progressDialogCanceled()
+{
+  if(isLoadingScenery())
+  {
+    qDebug() << "Canceling scenery library loading";
+
+    // Thread will stop at next progress report
+    loadingCanceled = true;
+    mainWindow->setStatusMessage(tr("Canceling loading of scenery library."));
+  }
+}
+
+/* Show errors that occured during loading, if any */
+void DatabaseManager::showLoadingErrors()
+{
+  const atools::fs::NavDatabaseErrors& errors = *loadingErrors;
   if(!errors.sceneryErrors.isEmpty())
   {
     QString errorTexts;
@@ -680,175 +881,181 @@ bool DatabaseManager::loadScenery()
       numScenery++;
     }
 
-    QMessageBox::warning(progressDialog, QApplication::applicationName(), errorTexts);
-  }
-
-  QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-  if(!progressDialog->wasCanceled() && success)
-  {
-    // Show results and wait until user selects ok
-    progressDialog->setCancelButtonText(tr("&OK"));
-    progressDialog->exec();
-  }
-  else
-    // Loading was cancelled
-    success = false;
-
-  if(!success)
-  {
-    // Something went wrong of loading was cancelled - restore backup
-    QGuiApplication::setOverrideCursor(Qt::WaitCursor);
-    restoreDatabaseFileBackup();
-    QGuiApplication::restoreOverrideCursor();
+    QMessageBox::warning(mainWindow, QApplication::applicationName(), errorTexts);
   }
-
-  // Delete backup file anyway after success of restore
-  removeDatabaseFileBackup();
-
-  delete progressDialog;
-  progressDialog = nullptr;
-
-  return success;
 }
 
 /* Simulator was changed in scenery database loading dialog */
 void DatabaseManager::simulatorChangedFromComboBox(FsPaths::SimulatorType value)
 {
-  // Close and reopen database to show statistics - but do not let the rest of the program know about it (no emit)
-  closeDatabase();
+  // Update statistics - the currently used database is not touched
   loadingFsType = value;
-  databaseFile = buildDatabaseFileName(loadingFsType);
-  openDatabase();
   updateDialogInfo();
 }
 
-/* Closes database, creates a database backup and reopens the database.
- * Result is a fresh database without schema. */
-void DatabaseManager::backupDatabaseFile()
+/* Replaces the database file with the newly loaded one. The old file is kept as a backup until the new one is in
+ * place. Database must be closed before. */
+bool DatabaseManager::swapDatabaseFile(const QString& tempFile, const QString& dbFile)
 {
-  qDebug() << "Creating database backup";
-  db->close();
-
-  QString backupName(db->databaseName() + lnm::DATABASE_BACKUP_SUFFIX);
+  QString backupName(dbFile + lnm::DATABASE_BACKUP_SUFFIX);
   QFile backupFile(backupName);
   bool removed = backupFile.remove();
   qDebug() << "removed database backup" << backupFile.fileName() << removed;
 
-  QFile dbFile(db->databaseName());
-  bool renamed = dbFile.rename(backupName);
-  qDebug() << "renamed database from" << db->databaseName() << "to" << backupName << renamed;
-
-  db->open();
-}
+  bool hasOld = QFile::exists(dbFile);
+  if(hasOld)
+  {
+    bool renamed = QFile::rename(dbFile, backupName);
+    qDebug() << "renamed database from" << dbFile << "to" << backupName << renamed;
 
-/* Closes database, restores the database backup and reopens the database. */
-void DatabaseManager::restoreDatabaseFileBackup()
-{
-  qDebug() << "Restoring database backup";
-  db->close();
+    if(!renamed)
+    {
+      QMessageBox::warning(mainWindow, QApplication::applicationName(),
+                           tr("Cannot replace database<br/><br/><i>%1</i>.").arg(dbFile));
+      return false;
+    }
+  }
 
-  QFile dbFile(db->databaseName());
-  bool removed = dbFile.remove();
-  qDebug() << "removed database" << dbFile.fileName() << removed;
+  bool renamed = QFile::rename(tempFile, dbFile);
+  qDebug() << "renamed database from" << tempFile << "to" << dbFile << renamed;
 
-  QString backupName(db->databaseName() + lnm::DATABASE_BACKUP_SUFFIX);
-  QFile backupFile(backupName);
-  bool copied = backupFile.copy(db->databaseName());
-  qDebug() << "copied database from" << backupName << "to" << db->databaseName() << copied;
+  if(!renamed)
+  {
+    if(hasOld)
+    {
+      // Restore backup
+      bool restored = QFile::rename(backupName, dbFile);
+      qDebug() << "renamed database from" << backupName << "to" << dbFile << restored;
+    }
 
-  db->open();
-}
+    QMessageBox::warning(mainWindow, QApplication::applicationName(),
+                         tr("Cannot replace database<br/><br/><i>%1</i>.").arg(dbFile));
+    return false;
+  }
 
-/* Removes the database backup */
-void DatabaseManager::removeDatabaseFileBackup()
-{
-  qDebug() << "Removing database backup";
-  QString backupName(db->databaseName() + lnm::DATABASE_BACKUP_SUFFIX);
-  QFile backupFile(backupName);
-  bool removed = backupFile.remove();
-  qDebug() << "removed database" << backupFile.fileName() << removed;
+  // Remove backup after success
+  removed = backupFile.remove();
+  qDebug() << "removed database backup" << backupFile.fileName() << removed;
+  return true;
 }
 
-/* Called by atools::fs::NavDatabase. Updates progress bar and statistics */
+/* Called by atools::fs::NavDatabase in the loading thread. Copies statistics and stage times for the
+ * progress window. Returns true to cancel loading. */
 bool DatabaseManager::progressCallback(const atools::fs::NavDatabaseProgress& progress,
                                        QElapsedTimer& timer)
 {
   if(progress.isFirstCall())
-  {
     timer.start();
-    progressDialog->setMinimum(0);
-    progressDialog->setMaximum(progress.getTotal());
+
+  QMutexLocker locker(&progressMutex);
+  LoadingProgress& p = loadingProgress;
+
+  if(progress.isFirstCall())
+  {
+    p.currentStage = DATABASE_STAGE_READING;
+    p.currentStageStart = 0L;
   }
 
-  // Update only four times a second
-  if((timer.elapsed() - progressTimerElapsed) > 250 || progress.isLastCall())
+  p.current = progress.getCurrent();
+  p.total = progress.getTotal();
+  p.numErrors = progress.getNumErrors();
+  p.numFiles = progress.getNumFiles();
+  p.numAirports = progress.getNumAirports();
+  p.numVors = progress.getNumVors();
+  p.numIls = progress.getNumIls();
+  p.numNdbs = progress.getNumNdbs();
+  p.numMarker = progress.getNumMarker();
+  p.numWaypoints = progress.getNumWaypoints();
+
+  if(progress.isNewOther())
   {
-    progressDialog->setValue(progress.getCurrent());
+    // Run script etc.
+    p.isOther = true;
+    p.bglFilePath.clear();
+    p.otherAction = progress.getOtherAction();
 
-    if(progress.isNewOther())
-    {
-      currentBglFilePath.clear();
-
-      // Run script etc.
-      progressDialog->setLabelText(
-        DATABASE_TIME_TEXT.arg(progress.getOtherAction()).
-        arg(formatter::formatElapsed(timer)).
-        arg(QString()).
-        arg(QString()).
-        arg(progress.getNumErrors()).
-        arg(progress.getNumFiles()).
-        arg(progress.getNumAirports()).
-        arg(progress.getNumVors()).
-        arg(progress.getNumIls()).
-        arg(progress.getNumNdbs()).
-        arg(progress.getNumMarker()).
-        arg(progress.getNumWaypoints()));
-    }
-    else if(progress.isNewSceneryArea() || progress.isNewFile())
+    // Close the current stage and start a new one
+    if(p.currentStage != p.otherAction)
     {
-      currentBglFilePath = progress.getBglFilePath();
-
-      // Switched to a new scenery area
-      progressDialog->setLabelText(
-        DATABASE_LOADING_TEXT.arg(progress.getSceneryTitle()).
-        arg(progress.getSceneryPath()).
-        arg(progress.getBglFileName()).
-        arg(formatter::formatElapsed(timer)).
-        arg(progress.getNumErrors()).
-        arg(progress.getNumFiles()).
-        arg(progress.getNumAirports()).
-        arg(progress.getNumVors()).
-        arg(progress.getNumIls()).
-        arg(progress.getNumNdbs()).
-        arg(progress.getNumMarker()).
-        arg(progress.getNumWaypoints()));
-    }
-    else if(progress.isLastCall())
-    {
-      currentBglFilePath.clear();
-      progressDialog->setValue(progress.getTotal());
-
-      // Last report
-      progressDialog->setLabelText(
-        DATABASE_TIME_TEXT.arg(tr("<big>Done.</big>")).
-        arg(formatter::formatElapsed(timer)).
-        arg(QString()).
-        arg(QString()).
-        arg(progress.getNumErrors()).
-        arg(progress.getNumFiles()).
-        arg(progress.getNumAirports()).
-        arg(progress.getNumVors()).
-        arg(progress.getNumIls()).
-        arg(progress.getNumNdbs()).
-        arg(progress.getNumMarker()).
-        arg(progress.getNumWaypoints()));
+      p.stageTimes.append(qMakePair(p.currentStage, timer.elapsed() - p.currentStageStart));
+      p.currentStage = p.otherAction;
+      p.currentStageStart = timer.elapsed();
     }
+  }
+  else if(progress.isNewSceneryArea() || progress.isNewFile())
+  {
+    // Switched to a new scenery area or file
+    p.isOther = false;
+    p.bglFilePath = progress.getBglFilePath();
+    p.bglFileName = progress.getBglFileName();
+    p.sceneryTitle = progress.getSceneryTitle();
+    p.sceneryPath = progress.getSceneryPath();
+  }
+
+  if(progress.isLastCall())
+  {
+    p.isLast = true;
+    p.bglFilePath.clear();
+    p.current = progress.getTotal();
+    p.stageTimes.append(qMakePair(p.currentStage, timer.elapsed() - p.currentStageStart));
+    p.currentStage.clear();
+  }
+
+  return loadingCanceled;
+}
+
+/* Called by timer in the main thread. Updates progress bar, statistics, throughput and stage times */
+void DatabaseManager::updateProgressDialog()
+{
+  if(progressDialog == nullptr || progressDialog->wasCanceled())
+    return;
 
-    QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-    progressTimerElapsed = timer.elapsed();
+  LoadingProgress p;
+  {
+    QMutexLocker locker(&progressMutex);
+    p = loadingProgress;
+  }
+
+  qint64 elapsed = loadingTimer.elapsed();
+  QString elapsedText = formatter::formatElapsed(elapsed);
+
+  QString text;
+  if(p.isLast)
+    // Last report
+    text = DATABASE_TIME_TEXT.arg(tr("<big>Done.</big>")).
+           arg(elapsedText).arg(QString()).arg(QString()).
+           arg(p.numErrors).arg(p.numFiles).arg(p.numAirports).arg(p.numVors).arg(p.numIls).
+           arg(p.numNdbs).arg(p.numMarker).arg(p.numWaypoints);
+  else if(p.isOther)
+    // Run script etc.
+    text = DATABASE_TIME_TEXT.arg(p.otherAction).
+           arg(elapsedText).arg(QString()).arg(QString()).
+           arg(p.numErrors).arg(p.numFiles).arg(p.numAirports).arg(p.numVors).arg(p.numIls).
+           arg(p.numNdbs).arg(p.numMarker).arg(p.numWaypoints);
+  else
+    // Reading scenery areas and files
+    text = DATABASE_LOADING_TEXT.arg(p.sceneryTitle).arg(p.sceneryPath).arg(p.bglFileName).
+           arg(elapsedText).
+           arg(p.numErrors).arg(p.numFiles).arg(p.numAirports).arg(p.numVors).arg(p.numIls).
+           arg(p.numNdbs).arg(p.numMarker).arg(p.numWaypoints);
+
+  // Files per second in the reading stage
+  qint64 readingMs = p.currentStage == DATABASE_STAGE_READING ? elapsed : 0L;
+  for(const QPair<QString, qint64>& stage : p.stageTimes)
+  {
+    if(stage.first == DATABASE_STAGE_READING)
+      readingMs = stage.second;
   }
+  if(readingMs > 0L)
+    text.append(DATABASE_THROUGHPUT_TEXT.arg(p.numFiles * 1000L / readingMs));
+
+  // Time used by each finished stage
+  for(const QPair<QString, qint64>& stage : p.stageTimes)
+    text.append(DATABASE_STAGE_TEXT.arg(stage.first).arg(formatter::formatElapsed(stage.second)));
 
-  return progressDialog->wasCanceled();
+  progressDialog->setMaximum(p.total);
+  progressDialog->setValue(p.current);
+  progressDialog->setLabelText(text);
 }
 
 /* Checks if the current database has a schema. Exits program if this fails */
@@ -948,41 +1155,59 @@ void DatabaseManager::restoreState()
   loadingFsType = atools::fs::FsPaths::stringToType(s.valueStr(lnm::DATABASE_LOADINGSIMULATOR));
 }
 
-/* Updates metadata, version and object counts in the scenery loading dialog */
+/* Updates metadata, version and object counts in the scenery loading dialog.
+ * Uses a separate connection to leave the currently used database alone. */
 void DatabaseManager::updateDialogInfo()
 {
-  QString metaText;
-  DatabaseMeta dbmeta(db);
-  if(!dbmeta.isValid())
-    metaText = DATABASE_META_TEXT.arg(tr("None")).
-               arg(tr("None")).
-               arg(tr("None")).
-               arg(DatabaseMeta::DB_VERSION_MAJOR).
-               arg(DatabaseMeta::DB_VERSION_MINOR);
-  else
-    metaText = DATABASE_META_TEXT.
-               arg(dbmeta.getLastLoadTime().isValid() ? dbmeta.getLastLoadTime().toString() : tr("None")).
-               arg(dbmeta.getMajorVersion()).
-               arg(dbmeta.getMinorVersion()).
-               arg(DatabaseMeta::DB_VERSION_MAJOR).
-               arg(DatabaseMeta::DB_VERSION_MINOR);
-
-  QString tableText;
-  if(hasSchema())
+  QString metaText, tableText;
+
+  // Need empty block to delete infoDb before removing driver
   {
-    atools::sql::SqlUtil util(db);
-
-    // Get row counts for the dialog
-    tableText = DATABASE_INFO_TEXT.arg(util.rowCount("bgl_file")).
-                arg(util.rowCount("airport")).
-                arg(util.rowCount("vor")).
-                arg(util.rowCount("ils")).
-                arg(util.rowCount("ndb")).
-                arg(util.rowCount("marker")).
-                arg(util.rowCount("waypoint"));
+    SqlDatabase infoDb = SqlDatabase::addDatabase(DATABASE_TYPE, DATABASE_NAME_INFO);
+
+    QString dbName = buildDatabaseFileName(loadingFsType);
+    bool exists = QFile::exists(dbName);
+    if(exists)
+    {
+      infoDb.setDatabaseName(dbName);
+      infoDb.open();
+    }
+
+    DatabaseMeta dbmeta(&infoDb);
+    if(!exists || !dbmeta.isValid())
+      metaText = DATABASE_META_TEXT.arg(tr("None")).
+                 arg(tr("None")).
+                 arg(tr("None")).
+                 arg(DatabaseMeta::DB_VERSION_MAJOR).
+                 arg(DatabaseMeta::DB_VERSION_MINOR);
+    else
+      metaText = DATABASE_META_TEXT.
+                 arg(dbmeta.getLastLoadTime().isValid() ? dbmeta.getLastLoadTime().toString() : tr("None")).
+                 arg(dbmeta.getMajorVersion()).
+                 arg(dbmeta.getMinorVersion()).
+                 arg(DatabaseMeta::DB_VERSION_MAJOR).
+                 arg(DatabaseMeta::DB_VERSION_MINOR);
+
+    if(exists && dbmeta.hasSchema())
+    {
+      atools::sql::SqlUtil util(&infoDb);
+
+      // Get row counts for the dialog
+      tableText = DATABASE_INFO_TEXT.arg(util.rowCount("bgl_file")).
+                  arg(util.rowCount("airport")).
+                  arg(util.rowCount("vor")).
+                  arg(util.rowCount("ils")).
+                  arg(util.rowCount("ndb")).
+                  arg(util.rowCount("marker")).
+                  arg(util.rowCount("waypoint"));
+    }
+    else
+      tableText = DATABASE_INFO_TEXT.arg(0).arg(0).arg(0).arg(0).arg(0).arg(0).arg(0);
+
+    if(exists)
+      infoDb.close();
   }
-  else
-    tableText = DATABASE_INFO_TEXT.arg(0).arg(0).arg(0).arg(0).arg(0).arg(0).arg(0);
+  SqlDatabase::removeDatabase(DATABASE_NAME_INFO);
 
   databaseDialog->setHeader(metaText + tr("<p><big>Currently Loaded:</big></p><p>%1</p>").arg(tableText));
 }
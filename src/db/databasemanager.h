@@ -24,10 +24,18 @@
 
 #include <QAction>
 #include <QObject>
+#include <QFutureWatcher>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <atomic>
+#include <exception>
 
 namespace atools {
 namespace fs {
 class NavDatabaseProgress;
+class NavDatabaseOptions;
+struct NavDatabaseErrors;
 namespace db {
 class DatabaseMeta;
 }
@@ -35,7 +43,6 @@ class DatabaseMeta;
 }
 
 class QProgressDialog;
-class QElapsedTimer;
 class DatabaseDialog;
 class MainWindow;
 class QSplashScreen;
@@ -58,9 +65,17 @@ public:
   /* Also closes database if not already done */
   virtual ~DatabaseManager();
 
-  /* Opens the dialog that allows to (re)load a new scenery database. */
+  /* Opens the dialog that allows to (re)load a new scenery database.
+   * Loading is done in a background thread into a new database file which replaces the current one when done.
+   * Shows the progress window instead if loading is already running. */
   void run();
 
+  /* true if the scenery library is currently loaded in the background */
+  bool isLoadingScenery() const
+  {
+    return loadingFuture.isRunning();
+  }
+
   /* Save and restore all paths and current simulator settings */
   void saveState();
   void restoreState();
@@ -125,29 +140,66 @@ private:
   bool hasSchema();
   bool hasData();
 
+  /* Result of the background scenery loading thread */
+  struct LoadingResult
+  {
+    bool success = false, canceled = false;
+
+    /* Exception caught in the thread to be shown in the main thread */
+    std::exception_ptr exception;
+  };
+
+  /* Copy of the progress values reported by the loading thread for display in the GUI thread.
+   * Guarded by progressMutex. */
+  struct LoadingProgress
+  {
+    QString sceneryTitle, sceneryPath, bglFileName, bglFilePath, otherAction;
+    int current = 0, total = 0, numErrors = 0, numFiles = 0, numAirports = 0, numVors = 0, numIls = 0,
+        numNdbs = 0, numMarker = 0, numWaypoints = 0;
+    bool isOther = false, isLast = false;
+
+    /* Finished loading stages and their duration in milliseconds */
+    QList<QPair<QString, qint64> > stageTimes;
+    QString currentStage;
+    qint64 currentStageStart = 0L;
+  };
+
+  /* Called by atools::fs::NavDatabase in the loading thread */
   bool progressCallback(const atools::fs::NavDatabaseProgress& progress, QElapsedTimer& timer);
 
+  QStringList databasePragmas() const;
+
   void simulatorChangedFromComboBox(atools::fs::FsPaths::SimulatorType value);
   bool runInternal();
-  void backupDatabaseFile();
-  void restoreDatabaseFileBackup();
   QString buildDatabaseFileName(atools::fs::FsPaths::SimulatorType currentFsType);
   void updateDialogInfo();
 
   void switchSimFromMainMenu();
   void freeActions();
   void updateSimSwitchActions();
-  void removeDatabaseFileBackup();
   void updateSimulatorFlags();
   void updateSimulatorPathsFromDialog();
-  bool loadScenery();
+
+  /* Start loading into a temporary database file in a background thread */
+  void loadScenery();
+  LoadingResult loadSceneryThread(QStringList pragmas);
+  void loadSceneryThreadFinished();
+
+  /* Update the non-modal progress window from the last values reported by the thread */
+  void updateProgressDialog();
+  void progressDialogCanceled();
+  void showLoadingErrors();
+
+  /* Replace the database file with the new temporary one. Keeps a backup until the file was replaced. */
+  bool swapDatabaseFile(const QString& tempFile, const QString& dbFile);
 
   const QString DATABASE_NAME = "LNMDB";
+  const QString DATABASE_NAME_LOADING = "LNMDBLOADING";
+  const QString DATABASE_NAME_INFO = "LNMDBINFO";
   const QString DATABASE_TYPE = "QSQLITE";
 
   DatabaseDialog *databaseDialog = nullptr;
   QString databaseFile, databaseDirectory;
-  qint64 progressTimerElapsed = 0L;
 
   // Need a pointer since it has to be deleted before the destructor is left
   atools::sql::SqlDatabase *db = nullptr;
@@ -168,7 +220,27 @@ private:
   /* List of simulator installations and databases */
   SimulatorTypeMap simulators;
 
-  QString currentBglFilePath;
+  /* Background loading of the scenery library */
+  QFuture<LoadingResult> loadingFuture;
+  QFutureWatcher<LoadingResult> loadingWatcher;
+
+  /* Options and errors used by the loading thread. Only valid while loading. */
+  atools::fs::NavDatabaseOptions *loadingOptions = nullptr;
+  atools::fs::NavDatabaseErrors *loadingErrors = nullptr;
+
+  /* New database file that is filled by the thread */
+  QString loadingDatabaseFile;
+  std::atomic_bool loadingCanceled{false};
+
+  /* Calculate procedure legs after loading - read from settings before starting the thread */
+  bool loadingProcedureGeometry = true;
+
+  QMutex progressMutex;
+  LoadingProgress loadingProgress;
+
+  /* Updates the progress window periodically while loading */
+  QTimer progressTimer;
+  QElapsedTimer loadingTimer;
 };
 
 #endif // LITTLENAVMAP_DATABASEMANAGER_H
@@ -166,25 +166,32 @@ int CsvExporter::selectionAsCsv(QTableView *view, bool includeHeader, QString& r
   {
     QTextStream stream(&result, QIODevice::WriteOnly);
     QHeaderView *header = view->horizontalHeader();
+
+    // Resolve visible columns in visual order once instead of for each row
+    QVector<int> logicalColumns;
+    for(int i = 0; i < model->columnCount(); i++)
+      if(!view->isColumnHidden(i))
+        logicalColumns.append(header->logicalIndex(i));
+
     if(includeHeader)
     {
       QStringList headers;
-      for(int i = 0; i < model->columnCount(); i++)
-        if(!view->isColumnHidden(i))
-          headers.append(model->headerData(header->logicalIndex(i), Qt::Horizontal).
-                         toString().replace("-\n", "").replace("\n", " "));
+      for(int col : logicalColumns)
+        headers.append(model->headerData(col, Qt::Horizontal).
+                       toString().replace("-\n", "").replace("\n", " "));
 
       stream << exporter.getResultSetHeader(headers);
     }
 
+    QVariantList vars;
+    vars.reserve(logicalColumns.size());
     for(QItemSelectionRange rng : view->selectionModel()->selection())
     {
       for(int row = rng.top(); row <= rng.bottom(); ++row)
       {
-        QVariantList vars;
-        for(int i = 0; i < model->columnCount(); i++)
-          if(!view->isColumnHidden(i))
-            vars.append(model->data(model->index(row, header->logicalIndex(i))));
+        vars.clear();
+        for(int col : logicalColumns)
+          vars.append(model->data(model->index(row, col)));
         stream << exporter.getResultSetRow(vars);
         exported++;
       }
@@ -94,6 +94,8 @@ MainWindow::MainWindow()
   : QMainWindow(nullptr), ui(new Ui::MainWindow)
 {
   qDebug() << "MainWindow constructor";
+  startupTimer.start();
+  startupPhaseTimer.start();
 
   try
   {
@@ -111,6 +113,7 @@ MainWindow::MainWindow()
     marbleAbout->setApplicationTitle(QApplication::applicationName());
 
     setupUi();
+    logStartupPhase("User interface");
 
     qDebug() << "MainWindow Creating OptionsDialog";
     optionsDialog = new OptionsDialog(this);
@@ -121,11 +124,13 @@ MainWindow::MainWindow()
 
     // Remember original title
     mainWindowTitle = windowTitle();
+    logStartupPhase("Options");
 
     // Prepare database and queries
     qDebug() << "MainWindow Creating DatabaseManager";
     databaseManager = new DatabaseManager(this);
     databaseManager->openDatabase();
+    logStartupPhase("Open database");
 
     mapQuery = new MapQuery(this, databaseManager->getDatabase());
     mapQuery->initQueries();
@@ -135,6 +140,7 @@ MainWindow::MainWindow()
 
     approachQuery = new ApproachQuery(databaseManager->getDatabase(), mapQuery);
     approachQuery->initQueries();
+    logStartupPhase("Prepare queries");
 
     qDebug() << "MainWindow Creating Approach controller";
     approachController = new ApproachTreeController(this);
@@ -180,12 +186,14 @@ MainWindow::MainWindow()
 
     qDebug() << "MainWindow Creating PrintSupport";
     printSupport = new PrintSupport(this, mapQuery);
+    logStartupPhase("Create controllers and widgets");
 
     qDebug() << "MainWindow Connecting slots";
     connectAllSlots();
 
     qDebug() << "MainWindow Reading settings";
     readSettings();
+    logStartupPhase("Restore settings");
 
     updateActionStates();
 
@@ -194,6 +202,7 @@ MainWindow::MainWindow()
 
     qDebug() << "MainWindow Setting projection";
     mapWidget->setProjection(mapProjectionComboBox->currentData().toInt());
+    logStartupPhase("Map theme and projection");
 
     // Wait until everything is set up and update map
     updateMapObjectsShown();
@@ -203,6 +212,7 @@ MainWindow::MainWindow()
     loadNavmapLegend();
     updateLegend();
     updateWindowTitle();
+    logStartupPhase("Legend");
 
     qDebug() << "MainWindow Constructor done";
   }
@@ -597,6 +607,7 @@ void MainWindow::connectAllSlots()
   connect(optionsDialog, &OptionsDialog::optionsChanged, this, &MainWindow::distanceChanged);
   connect(optionsDialog, &OptionsDialog::optionsChanged, weatherReporter, &WeatherReporter::optionsChanged);
   connect(optionsDialog, &OptionsDialog::optionsChanged, searchController, &SearchController::optionsChanged);
+  connect(optionsDialog, &OptionsDialog::optionsChanged, approachQuery, &ApproachQuery::optionsChanged);
   connect(optionsDialog, &OptionsDialog::optionsChanged, approachController, &ApproachTreeController::optionsChanged);
   connect(optionsDialog, &OptionsDialog::optionsChanged, routeController, &RouteController::optionsChanged);
   connect(optionsDialog, &OptionsDialog::optionsChanged, infoController, &InfoController::optionsChanged);
@@ -611,6 +622,9 @@ void MainWindow::connectAllSlots()
   connect(routeController, &RouteController::routeChanged, mapWidget, &MapWidget::routeChanged);
   connect(routeController, &RouteController::preRouteCalc, profileWidget, &ProfileWidget::preRouteCalc);
   connect(routeController, &RouteController::showInformation, infoController, &InfoController::showInformation);
+  connect(routeController, &RouteController::routeChanged, infoController, &InfoController::routeChanged);
+  connect(routeController, &RouteController::routeChanged, weatherReporter, &WeatherReporter::routeChanged);
+  connect(routeController, &RouteController::routeChanged, this, &MainWindow::routeChangedPrefetchProcedures);
 
   connect(routeController, &RouteController::showApproaches, approachController,
           &ApproachTreeController::showApproaches);
@@ -682,6 +696,8 @@ void MainWindow::connectAllSlots()
   connect(ui->actionRouteCalcHighAlt, &QAction::triggered, routeController, &RouteController::calculateHighAlt);
   connect(ui->actionRouteCalcLowAlt, &QAction::triggered, routeController, &RouteController::calculateLowAlt);
   connect(ui->actionRouteCalcSetAlt, &QAction::triggered, routeController, &RouteController::calculateSetAlt);
+  connect(ui->actionRouteCalcAlternatives, &QAction::triggered, routeController,
+          &RouteController::calculateAlternatives);
   connect(ui->actionRouteReverse, &QAction::triggered, routeController, &RouteController::reverseRoute);
 
   connect(ui->actionRouteCopyString, &QAction::triggered, routeController, &RouteController::routeStringToClipboard);
@@ -1624,11 +1640,24 @@ void MainWindow::options()
     setStatusMessage(tr("Options changed."));
 }
 
+/* Log duration of the phase that just ended and restart the phase timer */
+void MainWindow::logStartupPhase(const QString& phase)
+{
+  qInfo().noquote() << "Startup phase" << phase << "took" << startupPhaseTimer.restart() << "ms, total"
+                    << startupTimer.elapsed() << "ms";
+}
+
 /* Called by window shown event when the main window is visible the first time */
 void MainWindow::mainWindowShown()
 {
   qDebug() << Q_FUNC_INFO;
 
+  logStartupPhase("Show main window");
+
+  // Build the route from the flight plan file that was read in background
+  routeController->restoreFlightplan();
+  logStartupPhase("Restore flight plan");
+
   // Postpone loading of KML etc. until now when everything is set up
   mapWidget->mainWindowShown();
   profileWidget->mainWindowShown();
@@ -1677,6 +1706,7 @@ void MainWindow::mainWindowShown()
   weatherUpdateTimer.setInterval(WEATHER_UPDATE_MS);
   weatherUpdateTimer.start();
 
+  logStartupPhase("Startup done");
   setStatusMessage(tr("Ready."));
 
   // TODO DEBUG
@@ -1750,12 +1780,30 @@ void MainWindow::updateActionStates()
   ui->actionRouteCalcHighAlt->setEnabled(canCalcRoute);
   ui->actionRouteCalcLowAlt->setEnabled(canCalcRoute);
   ui->actionRouteCalcSetAlt->setEnabled(canCalcRoute && ui->spinBoxRouteAlt->value() > 0);
+  ui->actionRouteCalcAlternatives->setEnabled(canCalcRoute && ui->spinBoxRouteAlt->value() > 0);
   ui->actionRouteReverse->setEnabled(canCalcRoute);
 
   ui->actionMapShowHome->setEnabled(mapWidget->getHomePos().isValid());
   ui->actionMapShowMark->setEnabled(mapWidget->getSearchMarkPos().isValid());
 }
 
+/* Build all procedures of departure and destination in background */
+void MainWindow::routeChangedPrefetchProcedures(bool geometryChanged)
+{
+  if(!geometryChanged)
+    return;
+
+  const RouteMapObjectList& route = routeController->getRouteMapObjects();
+  QList<maptypes::MapAirport> airports;
+  if(route.hasValidDeparture())
+    airports.append(route.first().getAirport());
+  if(route.hasValidDestination())
+    airports.append(route.last().getAirport());
+
+  if(!airports.isEmpty())
+    approachQuery->prefetchProcedures(airports);
+}
+
 /* Read settings for all windows, docks, controller and manager classes */
 void MainWindow::readSettings()
 {
@@ -25,6 +25,7 @@
 #include <QUrl>
 #include <QFileInfoList>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <marble/MarbleGlobal.h>
 
 class SearchController;
@@ -196,6 +197,7 @@ private:
   void approachSelected(maptypes::MapApproachRef approachRef);
 
   void routeSelectionChanged(int selected, int total);
+  void routeChangedPrefetchProcedures(bool geometryChanged);
 
   void routeNewFromString();
   void routeNew();
@@ -240,6 +242,10 @@ private:
   /* Emit a signal windowShown after first appearance */
   virtual void showEvent(QShowEvent *event) override;
   void weatherUpdateTimeout();
+
+  /* Log time needed for the last startup phase and the time since start of the constructor */
+  void logStartupPhase(const QString& phase);
+
   void fillActiveSkyType(maptypes::WeatherContext& weatherContext, const QString& airportIdent) const;
 
   /* Original unchanged window title */
@@ -296,6 +302,9 @@ private:
 
   QTimer weatherUpdateTimer;
 
+  /* Measure duration of startup phases for the log */
+  QElapsedTimer startupTimer, startupPhaseTimer;
+
   bool firstStart = true /* emit window shown only once after startup */,
        firstApplicationStart = false /* first starup on a system after installation */;
 
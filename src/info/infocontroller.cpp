@@ -25,6 +25,7 @@
 #include "gui/widgetstate.h"
 #include "mapgui/mapquery.h"
 #include "route/routecontroller.h"
+#include "route/routemapobjectlist.h"
 #include "settings/settings.h"
 #include "ui_mainwindow.h"
 #include "util/htmlbuilder.h"
@@ -278,9 +279,10 @@ void InfoController::updateAirportInternal(bool newAirport)
 
       // qDebug() << Q_FUNC_INFO << "Updating html" << airport.ident << airport.id;
 
-      infoBuilder->airportText(airport, currentWeatherContext, html,
-                               &mainWindow->getRouteController()->getRouteMapObjects(),
-                               iconBackColor);
+      // Only the weather part is built again - all other parts are taken from the cache
+      html.append(airportFragment(FRAGMENT_AIRPORT_HEAD, airport));
+      infoBuilder->airportTextWeather(currentWeatherContext, html);
+      html.append(airportFragment(FRAGMENT_AIRPORT_TAIL, airport));
 
       Ui::MainWindow *ui = mainWindow->getUi();
       if(newAirport)
@@ -360,13 +362,8 @@ void InfoController::showInformationInternal(maptypes::MapSearchResult result, b
 
     updateAirportInternal(true);
 
-    html.clear();
-    infoBuilder->runwayText(airport, html, iconBackColor);
-    ui->textBrowserRunwayInfo->setText(html.getHtml());
-
-    html.clear();
-    infoBuilder->comText(airport, html, iconBackColor);
-    ui->textBrowserComInfo->setText(html.getHtml());
+    ui->textBrowserRunwayInfo->setText(airportFragment(FRAGMENT_RUNWAY, airport));
+    ui->textBrowserComInfo->setText(airportFragment(FRAGMENT_COM, airport));
 
     html.clear();
     maptypes::WeatherContext currentWeatherContext;
@@ -396,7 +393,7 @@ void InfoController::showInformationInternal(maptypes::MapSearchResult result, b
   for(const maptypes::MapVor& vor : result.vors)
   {
     currentSearchResult.vors.append(vor);
-    infoBuilder->vorText(vor, html, iconBackColor);
+    html.append(vorFragment(vor));
     html.br();
     foundNavaid = true;
   }
@@ -404,7 +401,7 @@ void InfoController::showInformationInternal(maptypes::MapSearchResult result, b
   for(const maptypes::MapNdb& ndb : result.ndbs)
   {
     currentSearchResult.ndbs.append(ndb);
-    infoBuilder->ndbText(ndb, html, iconBackColor);
+    html.append(ndbFragment(ndb));
     html.br();
     foundNavaid = true;
   }
@@ -412,7 +409,7 @@ void InfoController::showInformationInternal(maptypes::MapSearchResult result, b
   for(const maptypes::MapWaypoint& waypoint : result.waypoints)
   {
     currentSearchResult.waypoints.append(waypoint);
-    infoBuilder->waypointText(waypoint, html, iconBackColor);
+    html.append(waypointFragment(waypoint));
     html.br();
     foundNavaid = true;
   }
@@ -491,6 +488,7 @@ void InfoController::preDatabaseLoad()
   // Clear current airport and navaids result
   currentSearchResult = maptypes::MapSearchResult();
   databaseLoadStatus = true;
+  htmlFragmentCache.clear();
   clearInfoTextBrowsers();
 }
 
@@ -580,17 +578,18 @@ void InfoController::updateAiAirports(const atools::fs::sc::SimConnectData& data
     const QVector<atools::fs::sc::SimConnectAircraft>& newAiAircraft = data.getAiAircraft();
     QVector<atools::fs::sc::SimConnectAircraft> newAiAircraftShown;
 
+    // Index new list by object id to avoid a quadratic search
+    QHash<quint32, int> newAiIndex;
+    newAiIndex.reserve(newAiAircraft.size());
+    for(int i = 0; i < newAiAircraft.size(); i++)
+      newAiIndex.insert(newAiAircraft.at(i).getObjectId(), i);
+
     // Find all aircraft currently shown on the page in the newly arrived ai list
-    for(SimConnectAircraft& aircraft : currentSearchResult.aiAircraft)
+    for(const SimConnectAircraft& aircraft : currentSearchResult.aiAircraft)
     {
-      QVector<atools::fs::sc::SimConnectAircraft>::const_iterator it =
-        std::find_if(newAiAircraft.begin(), newAiAircraft.end(),
-                     [ = ](const SimConnectAircraft &ac)->bool
-                     {
-                       return ac.getObjectId() == aircraft.getObjectId();
-                     });
-      if(it != newAiAircraft.end())
-        newAiAircraftShown.append(*it);
+      int index = newAiIndex.value(aircraft.getObjectId(), -1);
+      if(index != -1)
+        newAiAircraftShown.append(newAiAircraft.at(index));
     }
 
     // Overwite old list
@@ -623,12 +622,123 @@ void InfoController::disconnectedFromSimulator()
 
 void InfoController::optionsChanged()
 {
+  // Units or other display options might have changed
+  htmlFragmentCache.clear();
   iconBackColor = QApplication::palette().color(QPalette::Active, QPalette::Base);
   updateTextEditFontSizes();
   infoBuilder->updateAircraftIcons(true);
   showInformationInternal(currentSearchResult, false);
 }
 
+void InfoController::routeChanged(bool geometryChanged)
+{
+  if(databaseLoadStatus || !geometryChanged)
+    return;
+
+  // Prepare the HTML for all airports in the plan so that showing them later needs no database access
+  // Fragments for airports already in the cache are not built again
+  // The head is not prepared since it depends on the flight plan position and is never cached for plan airports
+  const RouteMapObjectList& route = mainWindow->getRouteController()->getRouteMapObjects();
+  for(int i = 0; i < route.size(); i++)
+  {
+    const RouteMapObject& rmo = route.at(i);
+    if(rmo.getMapObjectType() == maptypes::AIRPORT)
+    {
+      const maptypes::MapAirport& airport = rmo.getAirport();
+      airportFragment(FRAGMENT_AIRPORT_TAIL, airport);
+      airportFragment(FRAGMENT_RUNWAY, airport);
+      airportFragment(FRAGMENT_COM, airport);
+    }
+  }
+}
+
+QString InfoController::airportFragment(HtmlFragment fragment, const maptypes::MapAirport& airport)
+{
+  const RouteMapObjectList& route = mainWindow->getRouteController()->getRouteMapObjects();
+
+  switch(fragment)
+  {
+    case FRAGMENT_AIRPORT_HEAD:
+      if(airport.routeIndex != -1)
+      {
+        // Head contains the flight plan position which changes with each edit - do not cache
+        HtmlBuilder html(true);
+        infoBuilder->airportTextHead(airport, html, &route, iconBackColor);
+        return html.getHtml();
+      }
+      else
+        return cachedFragment(fragment, airport.id, [&](HtmlBuilder& html) -> void
+                              {
+                                infoBuilder->airportTextHead(airport, html, &route, iconBackColor);
+                              });
+
+    case FRAGMENT_AIRPORT_TAIL:
+      return cachedFragment(fragment, airport.id, [&](HtmlBuilder& html) -> void
+                            {
+                              infoBuilder->airportTextTail(airport, html);
+                            });
+
+    case FRAGMENT_RUNWAY:
+      return cachedFragment(fragment, airport.id, [&](HtmlBuilder& html) -> void
+                            {
+                              infoBuilder->runwayText(airport, html, iconBackColor);
+                            });
+
+    case FRAGMENT_COM:
+      return cachedFragment(fragment, airport.id, [&](HtmlBuilder& html) -> void
+                            {
+                              infoBuilder->comText(airport, html, iconBackColor);
+                            });
+
+    case FRAGMENT_VOR:
+    case FRAGMENT_NDB:
+    case FRAGMENT_WAYPOINT:
+      break;
+  }
+  return QString();
+}
+
+QString InfoController::vorFragment(const maptypes::MapVor& vor)
+{
+  return cachedFragment(FRAGMENT_VOR, vor.id, [&](HtmlBuilder& html) -> void
+                        {
+                          infoBuilder->vorText(vor, html, iconBackColor);
+                        });
+}
+
+QString InfoController::ndbFragment(const maptypes::MapNdb& ndb)
+{
+  return cachedFragment(FRAGMENT_NDB, ndb.id, [&](HtmlBuilder& html) -> void
+                        {
+                          infoBuilder->ndbText(ndb, html, iconBackColor);
+                        });
+}
+
+QString InfoController::waypointFragment(const maptypes::MapWaypoint& waypoint)
+{
+  return cachedFragment(FRAGMENT_WAYPOINT, waypoint.id, [&](HtmlBuilder& html) -> void
+                        {
+                          infoBuilder->waypointText(waypoint, html, iconBackColor);
+                        });
+}
+
+QString InfoController::cachedFragment(HtmlFragment fragment, int id,
+                                       std::function<void(HtmlBuilder& html)> buildFunc)
+{
+  QString key = QString("%1_%2").arg(fragment).arg(id);
+
+  QString *cached = htmlFragmentCache.object(key);
+  if(cached != nullptr)
+    return *cached;
+
+  HtmlBuilder html(true);
+  buildFunc(html);
+
+  QString *text = new QString(html.getHtml());
+  htmlFragmentCache.insert(key, text);
+  return *text;
+}
+
 /* Update font size in text browsers if options have changed */
 void InfoController::updateTextEditFontSizes()
 {
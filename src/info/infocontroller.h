@@ -21,14 +21,23 @@
 #include "fs/sc/simconnectdata.h"
 #include "common/maptypes.h"
 
+#include <QCache>
 #include <QObject>
 
+#include <functional>
+
 class MainWindow;
 class MapQuery;
 class InfoQuery;
 class HtmlInfoBuilder;
 class QTextEdit;
 
+namespace atools {
+namespace util {
+class HtmlBuilder;
+}
+}
+
 namespace ic {
 enum TabIndex
 {
@@ -92,6 +101,9 @@ public:
 
   void updateAllInformation();
 
+  /* Flight plan has changed. Renders and caches the HTML fragments for all airports of a new plan. */
+  void routeChanged(bool geometryChanged);
+
 signals:
   /* Emitted when the user clicks on the "Map" link in the text browsers */
   void showPos(const atools::geo::Pos& pos, float zoom, bool doubleClick);
@@ -109,6 +121,29 @@ private:
   void updateAiAirports(const atools::fs::sc::SimConnectData& data);
   void updateAirportInternal(bool newAirport);
 
+  /* Types of HTML fragments in the cache */
+  enum HtmlFragment
+  {
+    FRAGMENT_AIRPORT_HEAD,
+    FRAGMENT_AIRPORT_TAIL,
+    FRAGMENT_RUNWAY,
+    FRAGMENT_COM,
+    FRAGMENT_VOR,
+    FRAGMENT_NDB,
+    FRAGMENT_WAYPOINT
+  };
+
+  /* Get HTML for the airport or navaid from the fragment cache or build it if not found */
+  QString airportFragment(HtmlFragment fragment, const maptypes::MapAirport& airport);
+  QString vorFragment(const maptypes::MapVor& vor);
+  QString ndbFragment(const maptypes::MapNdb& ndb);
+  QString waypointFragment(const maptypes::MapWaypoint& waypoint);
+  QString cachedFragment(HtmlFragment fragment, int id,
+                         std::function<void(atools::util::HtmlBuilder& html)> buildFunc);
+
+  /* Rendered HTML keyed by fragment type and object id. Cleared on database and option changes. */
+  QCache<QString, QString> htmlFragmentCache;
+
   bool databaseLoadStatus = false;
   atools::fs::sc::SimConnectData lastSimData;
   qint64 lastSimUpdate = 0;
@@ -28,10 +28,12 @@
 #include "db/databasemanager.h"
 #include "common/settingsmigrate.h"
 #include "common/aircrafttrack.h"
+#include "route/routebenchmark.h"
 #include "fs/sc/simconnectdata.h"
 #include "fs/sc/simconnectreply.h"
 
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QSplashScreen>
 #include <QSslSocket>
 #include <QStyleFactory>
@@ -83,6 +85,29 @@ int main(int argc, char *argv[])
 
   // Set application information
   int retval = 0;
+
+  // Run route calculation benchmark without GUI and exit if requested on the command line
+  if(RouteBenchmark::isRequested(argc, argv))
+  {
+    QCoreApplication coreApp(argc, argv);
+    QCoreApplication::setApplicationName("Little Navmap");
+    QCoreApplication::setOrganizationName("ABarthel");
+    QCoreApplication::setOrganizationDomain("abarthel.org");
+
+    try
+    {
+      LoggingHandler::initializeForTemp(atools::settings::Settings::getOverloadedPath(
+                                          ":/littlenavmap/resources/config/logging.cfg"));
+      RouteBenchmark::runFromCommandLine(QCoreApplication::arguments(), retval);
+    }
+    catch(const std::exception& e)
+    {
+      qCritical() << "Route benchmark failed" << e.what();
+      retval = 1;
+    }
+    return retval;
+  }
+
   Application app(argc, argv);
   Application::setWindowIcon(QIcon(":/littlenavmap/resources/icons/littlenavmap.svg"));
   Application::setApplicationName("Little Navmap");
@@ -187,8 +212,13 @@ int main(int argc, char *argv[])
 
     // Check if database is compatible and ask the user to erase all incompatible ones
     // If erasing databases is refused exit application
+    QElapsedTimer checkTimer;
+    checkTimer.start();
     dbManager = new DatabaseManager(nullptr);
-    if(dbManager->checkIncompatibleDatabases(&splash))
+    bool databasesOk = dbManager->checkIncompatibleDatabases(&splash);
+    qInfo() << "Startup phase Check databases took" << checkTimer.elapsed() << "ms";
+
+    if(databasesOk)
     {
       delete dbManager;
       dbManager = nullptr;
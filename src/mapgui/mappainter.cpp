@@ -21,6 +21,7 @@
 #include "common/symbolpainter.h"
 #include "geo/calculations.h"
 #include "mapgui/mapwidget.h"
+#include "atools.h"
 
 #include <marble/GeoDataLineString.h>
 #include <marble/GeoPainter.h>
@@ -56,6 +57,10 @@ MapPainter::MapPainter(MapWidget *parentMapWidget, MapQuery *mapQuery, MapScale
   : CoordinateConverter(parentMapWidget->viewport()), mapWidget(parentMapWidget), query(mapQuery), scale(mapScale)
 {
   symbolPainter = new SymbolPainter();
+
+  // Range rings have several circles each
+  circleCache.setMaxCost(500);
+  rhumbLineCache.setMaxCost(100);
 }
 
 MapPainter::~MapPainter()
@@ -88,10 +93,18 @@ void MapPainter::paintCircle(GeoPainter *painter, const Pos& centerPos, int radi
   int pixel = scale->getPixelIntForMeter(nmToMeter(radiusNm));
   int numPoints = std::min(std::max(pixel / (fast ? 20 : 2), CIRCLE_MIN_POINTS), CIRCLE_MAX_POINTS);
 
-  int radiusMeter = nmToMeter(radiusNm);
+  // Use only a few zoom buckets for the angle step to allow caching of the points
+  int step = numPoints >= CIRCLE_MAX_POINTS ? 5 : (numPoints >= CIRCLE_MAX_POINTS / 2 ? 10 : 20);
+
+  const CirclePoints& points = circlePoints(centerPos, radiusNm, step);
+  int count = points.lonX.size();
+
+  // Project all points at once
+  QVector<double> xs(count), ys(count);
+  QVector<bool> visibles(count), hiddens(count);
+  wToS(points.lonX.constData(), points.latY.constData(), count, xs.data(), ys.data(), visibles.data(),
+       DEFAULT_WTOS_SIZE, hiddens.data());
 
-  int step = 360 / numPoints;
-  int x1, y1, x2 = -1, y2 = -1;
   xtext = -1;
   ytext = -1;
 
@@ -99,21 +112,19 @@ void MapPainter::paintCircle(GeoPainter *painter, const Pos& centerPos, int radi
   QVector<int> ytexts;
 
   // Use north endpoint of radius as start position
-  Pos startPoint = centerPos.endpoint(radiusMeter, 0).normalize();
-  Pos p1 = startPoint;
-  bool hidden1 = true, hidden2 = true;
-  bool visible1 = wToS(p1, x1, y1, DEFAULT_WTOS_SIZE, &hidden1);
+  int x1 = atools::roundToInt(xs.at(0)), y1 = atools::roundToInt(ys.at(0));
+  bool visible1 = visibles.at(0), hidden1 = hiddens.at(0);
+  int p1 = 0;
 
   bool ringVisible = false, lastVisible = false;
   GeoDataLineString ellipse;
   ellipse.setTessellate(true);
   // Draw ring segments and collect potential text positions
-  for(int i = 0; i <= 360; i += step)
+  for(int p2 = 0; p2 < count; p2++)
   {
     // Line segment from p1 to p2
-    Pos p2 = centerPos.endpoint(radiusMeter, i).normalize();
-
-    bool visible2 = wToS(p2, x2, y2, DEFAULT_WTOS_SIZE, &hidden2);
+    int x2 = atools::roundToInt(xs.at(p2)), y2 = atools::roundToInt(ys.at(p2));
+    bool visible2 = visibles.at(p2), hidden2 = hiddens.at(p2);
 
     QRect rect(QPoint(x1, y1), QPoint(x2, y2));
     rect = rect.normalized();
@@ -125,7 +136,7 @@ void MapPainter::paintCircle(GeoPainter *painter, const Pos& centerPos, int radi
 
     if(lastVisible || nowVisible)
       // Last line or this one are visible add coords
-      ellipse.append(GeoDataCoordinates(p1.getLonX(), p1.getLatY(), 0, DEG));
+      ellipse.append(GeoDataCoordinates(points.lonX.at(p1), points.latY.at(p1), 0, DEG));
 
     if(lastVisible && !nowVisible)
     {
@@ -162,7 +173,7 @@ void MapPainter::paintCircle(GeoPainter *painter, const Pos& centerPos, int radi
     if(!ellipse.isEmpty())
     {
       // Last one always needs closing the circle
-      ellipse.append(GeoDataCoordinates(startPoint.getLonX(), startPoint.getLatY(), 0, DEG));
+      ellipse.append(GeoDataCoordinates(points.lonX.first(), points.latY.first(), 0, DEG));
       painter->drawPolyline(ellipse);
     }
 
@@ -180,6 +191,52 @@ void MapPainter::paintCircle(GeoPainter *painter, const Pos& centerPos, int radi
   }
 }
 
+const MapPainter::CirclePoints& MapPainter::circlePoints(const Pos& centerPos, int radiusNm, int step)
+{
+  GeometryKey key = {centerPos.getLonX(), centerPos.getLatY(), 0.f, 0.f, radiusNm, step};
+
+  CirclePoints *points = circleCache.object(key);
+  if(points == nullptr)
+  {
+    points = new CirclePoints;
+    int radiusMeter = nmToMeter(radiusNm);
+    for(int i = 0; i <= 360; i += step)
+    {
+      Pos pos = centerPos.endpoint(radiusMeter, i).normalize();
+      points->lonX.append(pos.getLonX());
+      points->latY.append(pos.getLatY());
+    }
+    circleCache.insert(key, points);
+  }
+  return *points;
+}
+
+const LineString& MapPainter::rhumbLinePoints(const Pos& from, const Pos& to, int numPoints)
+{
+  // Round up to the next power of two to get only a few zoom buckets but do not exceed the maximum
+  int num = 4;
+  while(num < numPoints)
+    num *= 2;
+  num = std::min(num, RHUMB_MAX_POINTS);
+
+  GeometryKey key = {from.getLonX(), from.getLatY(), to.getLonX(), to.getLatY(), 0, num};
+
+  LineString *points = rhumbLineCache.object(key);
+  if(points == nullptr)
+  {
+    points = new LineString;
+    float bearing = from.angleDegToRhumb(to);
+    float distanceMeter = from.distanceMeterToRhumb(to);
+
+    points->append(from);
+    for(int i = 1; i < num; i++)
+      points->append(from.endpointRhumb(distanceMeter * i / num, bearing));
+    points->append(from.endpointRhumb(distanceMeter, bearing));
+    rhumbLineCache.insert(key, points);
+  }
+  return *points;
+}
+
 void MapPainter::drawLineString(const PaintContext *context, const Marble::GeoDataLineString& linestring)
 {
   GeoDataLineString ls;
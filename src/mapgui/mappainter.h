@@ -21,10 +21,12 @@
 #include "common/coordinateconverter.h"
 #include "common/maptypes.h"
 #include "options/optiondata.h"
+#include "geo/linestring.h"
 
 #include <marble/MarbleWidget.h>
 #include <QPen>
 #include <QApplication>
+#include <QCache>
 
 namespace atools {
 namespace geo {
@@ -165,16 +167,57 @@ protected:
                                   QLineF *extensionLine, const QString& text, const QColor& textColor,
                                   const QColor& textColorBackground);
 
+  /* Get the cached sample points of a rhumb line. Number of points is rounded up to a power of two
+   * and limited to RHUMB_MAX_POINTS. */
+  const atools::geo::LineString& rhumbLinePoints(const atools::geo::Pos& from, const atools::geo::Pos& to,
+                                                 int numPoints);
+
   /* Minimum points to use for a circle */
   const int CIRCLE_MIN_POINTS = 16;
   /* Maximum points to use for a circle */
   const int CIRCLE_MAX_POINTS = 72;
+  /* Maximum points to use for a rhumb line */
+  const int RHUMB_MAX_POINTS = 72;
 
   SymbolPainter *symbolPainter;
   MapWidget *mapWidget;
   MapQuery *query;
   MapScale *scale;
 
+private:
+  /* Geodesic sample points of a circle or rhumb line for one zoom bucket */
+  struct GeometryKey
+  {
+    float lonX1, latY1, lonX2, latY2;
+    int radiusNm, numPoints;
+
+    bool operator==(const GeometryKey& other) const
+    {
+      return lonX1 == other.lonX1 && latY1 == other.latY1 && lonX2 == other.lonX2 && latY2 == other.latY2 &&
+             radiusNm == other.radiusNm && numPoints == other.numPoints;
+    }
+
+    friend uint qHash(const GeometryKey& key)
+    {
+      return ::qHash(key.lonX1) ^ ::qHash(key.latY1) ^ (::qHash(key.lonX2) << 1) ^ (::qHash(key.latY2) << 2) ^
+             static_cast<uint>(key.radiusNm << 8) ^ static_cast<uint>(key.numPoints);
+    }
+
+  };
+
+  /* Circle points as separate coordinate arrays for batched projection */
+  struct CirclePoints
+  {
+    QVector<double> lonX, latY;
+  };
+
+  /* Get the cached sample points of a circle. step is the angle between points in degree. */
+  const CirclePoints& circlePoints(const atools::geo::Pos& centerPos, int radiusNm, int step);
+
+  /* Sample points are reused across repaints and only calculated again if the zoom bucket changes */
+  QCache<GeometryKey, CirclePoints> circleCache;
+  QCache<GeometryKey, atools::geo::LineString> rhumbLineCache;
+
 };
 
 #endif // LITTLENAVMAP_MAPPAINTER_H
@@ -25,6 +25,7 @@
 #include "mapgui/maplayer.h"
 #include "common/unit.h"
 #include "util/paintercontextsaver.h"
+#include "common/aitraffic.h"
 
 #include <marble/GeoPainter.h>
 
@@ -77,10 +78,7 @@ void MapPainterAircraft::render(PaintContext *context)
     if(mapWidget->distance() < DISTANCE_CUT_OFF_AI_LIMIT)
     {
       if(context->objectTypes.testFlag(AIRCRAFT_AI))
-      {
-        for(const SimConnectAircraft& ac : mapWidget->getAiAircraft())
-          paintAiAircraft(context, ac);
-      }
+        paintAiTraffic(context);
     }
 
     if(context->objectTypes.testFlag(AIRCRAFT))
@@ -101,40 +99,65 @@ void MapPainterAircraft::render(PaintContext *context)
   }
 }
 
-void MapPainterAircraft::paintAiAircraft(const PaintContext *context,
-                                         const SimConnectAircraft& aiAircraft)
+/* Paint all AI aircraft in the viewport. Labels are omitted in crowded screen areas. */
+void MapPainterAircraft::paintAiTraffic(const PaintContext *context)
 {
-  if(!context->mapLayerEffective->isAirportDiagram() && aiAircraft.isOnGround())
-    return;
+  const AiTraffic& traffic = mapWidget->getAiTraffic();
 
-  if(aiAircraft.isUser())
-    return;
+  struct AiScreenPos
+  {
+    int index;
+    float x, y;
+    quint64 cell;
+  };
+
+  // Get only aircraft in the viewport from the grid and calculate screen positions
+  QVector<AiScreenPos> screenPositions;
+  QHash<quint64, int> aircraftPerCell;
+  for(int index : traffic.getIndexesInRect(context->viewportRect))
+  {
+    const SimConnectAircraft& ac = traffic.at(index);
+    if((!context->mapLayerEffective->isAirportDiagram() && ac.isOnGround()) || ac.isUser())
+      continue;
 
-  const Pos& pos = aiAircraft.getPosition();
+    // Move position along track for the time since the last packet
+    float x, y;
+    if(wToS(traffic.getExtrapolatedPosition(index), x, y))
+    {
+      // Cell key from screen column and row
+      quint32 col = static_cast<quint32>(static_cast<int>(x) / AI_LABEL_CELL_SIZE);
+      quint32 row = static_cast<quint32>(static_cast<int>(y) / AI_LABEL_CELL_SIZE);
+      quint64 cell = (static_cast<quint64>(col) << 32) | row;
+      screenPositions.append({index, x, y, cell});
+      aircraftPerCell[cell]++;
+    }
+  }
 
-  if(!pos.isValid())
-    return;
+  for(const AiScreenPos& pos : screenPositions)
+    paintAiAircraft(context, traffic.at(pos.index), pos.x, pos.y,
+                    aircraftPerCell.value(pos.cell) <= AI_LABEL_MAX_PER_CELL);
+}
 
-  float x, y;
-  if(wToS(pos, x, y))
-  {
-    int size = std::max(context->sz(context->symbolSizeAircraftAi, 32),
-                        scale->getPixelIntForFeet(aiAircraft.getWingSpan()));
-    context->szFont(context->textSizeAircraftAi);
-    int offset = -(size / 2);
+void MapPainterAircraft::paintAiAircraft(const PaintContext *context,
+                                         const SimConnectAircraft& aiAircraft, float x, float y, bool label)
+{
+  int size = std::max(context->sz(context->symbolSizeAircraftAi, 32),
+                      scale->getPixelIntForFeet(aiAircraft.getWingSpan()));
+  context->szFont(context->textSizeAircraftAi);
+  int offset = -(size / 2);
 
-    // Position is visible
-    context->painter->translate(x, y);
-    context->painter->rotate(atools::geo::normalizeCourse(aiAircraft.getHeadingDegTrue()));
+  // Position is visible
+  context->painter->translate(x, y);
+  context->painter->rotate(atools::geo::normalizeCourse(aiAircraft.getHeadingDegTrue()));
 
-    // Draw symbol
-    context->painter->drawPixmap(offset, offset, *pixmapFromCache(aiAircraft, size, false));
+  // Draw symbol
+  context->painter->drawPixmap(offset, offset, *pixmapFromCache(aiAircraft, size, false));
 
-    context->painter->resetTransform();
+  context->painter->resetTransform();
 
+  if(label)
     // Build text label
     paintTextLabelAi(context, x, y, size, aiAircraft);
-  }
 }
 
 void MapPainterAircraft::paintUserAircraft(const PaintContext *context,
@@ -174,15 +197,23 @@ void MapPainterAircraft::paintAircraftTrack(const PaintContext *context)
     painter->setPen(mapcolors::aircraftTrailPen(size));
     bool lastVisible = false;
 
-    int x1, y1;
+    // Convert all track points at once
+    QVector<Pos> positions;
+    positions.reserve(aircraftTrack.size());
+    for(int i = 0; i < aircraftTrack.size(); i++)
+      positions.append(aircraftTrack.at(i).pos);
+
+    QVector<QPoint> points;
+    wToS(positions, points);
+
+    int x1 = points.first().x(), y1 = points.first().y();
     int x2 = -1, y2 = -1;
     QRect vpRect(painter->viewport());
-    wToS(aircraftTrack.first().pos, x1, y1);
 
-    for(int i = 1; i < aircraftTrack.size(); i++)
+    for(int i = 1; i < points.size(); i++)
     {
-      const at::AircraftTrackPos& trackPos = aircraftTrack.at(i);
-      wToS(trackPos.pos, x2, y2);
+      x2 = points.at(i).x();
+      y2 = points.at(i).y();
 
       QRect rect(QPoint(x1, y1), QPoint(x2, y2));
       rect = rect.normalized();
@@ -75,8 +75,9 @@ private:
 
   void paintUserAircraft(const PaintContext *context,
                          const atools::fs::sc::SimConnectUserAircraft& userAircraft, float x, float y);
+  void paintAiTraffic(const PaintContext *context);
   void paintAiAircraft(const PaintContext *context,
-                       const atools::fs::sc::SimConnectAircraft& aiAircraft);
+                       const atools::fs::sc::SimConnectAircraft& aiAircraft, float x, float y, bool label);
 
   void paintTextLabelUser(const PaintContext *context, float x, float y, int size,
                           const atools::fs::sc::SimConnectUserAircraft& aircraft);
@@ -102,6 +103,10 @@ private:
 
   static Q_DECL_CONSTEXPR int DISTANCE_CUT_OFF_AI_LIMIT = 500;
 
+  /* Draw only symbols and no labels if more than AI_LABEL_MAX_PER_CELL aircraft are in a screen cell */
+  static Q_DECL_CONSTEXPR int AI_LABEL_CELL_SIZE = 100;
+  static Q_DECL_CONSTEXPR int AI_LABEL_MAX_PER_CELL = 4;
+
   static Q_DECL_CONSTEXPR int WIND_POINTER_SIZE = 40;
 
   /* Caches pixmaps generated from SVG graphics */
@@ -60,6 +60,7 @@ void MapPainterMark::render(PaintContext *context)
   paintRangeRings(context);
   paintDistanceMarkers(context);
   paintRouteDrag(context);
+  paintAlternativeRoutes(context);
   // paintMagneticPoles(context);
 }
 
@@ -441,26 +442,16 @@ void MapPainterMark::paintDistanceMarkers(const PaintContext *context)
       int pixel = scale->getPixelIntForMeter(distanceMeter);
       int numPoints = std::min(std::max(pixel / (context->drawFast ? 200 : 20), 4), 72);
 
-      Pos p1 = m.from, p2;
-
-      // Draw line segments
-      for(float d = 0.f; d < distanceMeter; d += distanceMeter / numPoints)
+      // Draw line segments using cached points - single segments avoid wrong lines across the anti-meridian
+      const LineString& points = rhumbLinePoints(m.from, m.to, numPoints);
+      for(int i = 1; i < points.size(); i++)
       {
-        p2 = m.from.endpointRhumb(d, bearing);
         GeoDataLineString line;
-        line.append(GeoDataCoordinates(p1.getLonX(), p1.getLatY(), 0, DEG));
-        line.append(GeoDataCoordinates(p2.getLonX(), p2.getLatY(), 0, DEG));
+        line.append(GeoDataCoordinates(points.at(i - 1).getLonX(), points.at(i - 1).getLatY(), 0, DEG));
+        line.append(GeoDataCoordinates(points.at(i).getLonX(), points.at(i).getLatY(), 0, DEG));
         painter->drawPolyline(line);
-        p1 = p2;
       }
 
-      // Draw rest
-      p2 = m.from.endpointRhumb(distanceMeter, bearing);
-      GeoDataLineString line;
-      line.append(GeoDataCoordinates(p1.getLonX(), p1.getLatY(), 0, DEG));
-      line.append(GeoDataCoordinates(p2.getLonX(), p2.getLatY(), 0, DEG));
-      painter->drawPolyline(line);
-
       // Build and draw text
       QStringList texts;
       if(!m.text.isEmpty())
@@ -521,3 +512,47 @@ void MapPainterMark::paintRouteDrag(const PaintContext *context)
     }
   }
 }
+
+/* Draw alternative routes while the user selects one. The selected route is drawn last and wider. */
+void MapPainterMark::paintAlternativeRoutes(const PaintContext *context)
+{
+  const QList<atools::geo::LineString>& routes = mapWidget->getAlternativeRoutes();
+  if(routes.isEmpty())
+    return;
+
+  GeoPainter *painter = context->painter;
+  int selected = mapWidget->getSelectedAlternativeRoute();
+
+  // Draw unselected first and the selected one on top
+  QList<int> order;
+  for(int i = 0; i < routes.size(); i++)
+  {
+    if(i != selected)
+      order.append(i);
+  }
+  if(selected >= 0 && selected < routes.size())
+    order.append(selected);
+
+  for(int i : order)
+  {
+    const atools::geo::LineString& line = routes.at(i);
+    if(line.size() < 2)
+      continue;
+
+    GeoDataLineString linestring;
+    linestring.setTessellate(true);
+    for(const atools::geo::Pos& pos : line)
+      linestring.append(GeoDataCoordinates(pos.getLonX(), pos.getLatY(), 0, DEG));
+
+    bool isSelected = i == selected;
+    painter->setPen(QPen(isSelected ? mapcolors::routeAlternativeSelectedColor : mapcolors::routeAlternativeColor,
+                         isSelected ? 5 : 2, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+    painter->drawPolyline(linestring);
+
+    // Label the route number at the middle point
+    int x, y;
+    if(wToS(line.at(line.size() / 2), x, y))
+      symbolPainter->textBox(painter, {QString::number(i + 1)}, painter->pen(), x, y,
+                             isSelected ? textatt::BOLD : textatt::NONE, 255);
+  }
+}
@@ -48,6 +48,7 @@ private:
   void paintRangeRings(const PaintContext *context);
   void paintDistanceMarkers(const PaintContext *context);
   void paintRouteDrag(const PaintContext *context);
+  void paintAlternativeRoutes(const PaintContext *context);
   void paintMagneticPoles(const PaintContext *context);
 
 };
@@ -27,6 +27,7 @@
 #include "mapgui/mapscale.h"
 #include "util/paintercontextsaver.h"
 #include "common/textplacement.h"
+#include "route/routegeometry.h"
 
 #include <QBitArray>
 #include <marble/GeoDataLineString.h>
@@ -154,11 +155,26 @@ void MapPainterRoute::paintRoute(const PaintContext *context)
   float outerlinewidth = context->sz(context->thicknessFlightplan, 7);
   float innerlinewidth = context->sz(context->thicknessFlightplan, 4);
 
+  // Interpolated legs are only recalculated on route changes and projected once per view
+  RouteGeometry& routeGeometry = routeController->getRouteGeometry();
+  routeGeometry.updateRoute(routeApprMapObjects);
+  routeGeometry.updateScreen(*this);
+
+  // Use the cached screen geometry for the globe - let Marble deal with the anti meridian in other projections
+  bool useRouteGeometry = context->viewport->projection() == Marble::Spherical &&
+                          routeGeometry.size() == linestring.size();
+
   // Draw lines separately to avoid omission in mercator near anti meridian
   // Draw outer line
   context->painter->setPen(QPen(mapcolors::routeOutlineColor, outerlinewidth, Qt::SolidLine,
                                 Qt::RoundCap, Qt::RoundJoin));
-  drawLineString(context, linestring);
+  if(useRouteGeometry)
+  {
+    for(int i = 1; i < routeGeometry.size(); i++)
+      drawRouteLeg(context, routeGeometry, i);
+  }
+  else
+    drawLineString(context, linestring);
 
   // Draw innner line
   context->painter->setPen(QPen(OptionData::instance().getFlightplanColor(), innerlinewidth,
@@ -167,22 +183,32 @@ void MapPainterRoute::paintRoute(const PaintContext *context)
   ls.setTessellate(true);
   for(int i = 1; i < linestring.size(); i++)
   {
-    ls.clear();
-    ls << linestring.at(i - 1) << linestring.at(i);
-    context->painter->drawPolyline(ls);
+    if(useRouteGeometry)
+      drawRouteLeg(context, routeGeometry, i);
+    else
+    {
+      ls.clear();
+      ls << linestring.at(i - 1) << linestring.at(i);
+      context->painter->drawPolyline(ls);
+    }
   }
 
   // Get active route leg
   int activeRouteLeg = routeApprMapObjects.getActiveRouteLeg();
 
-  if(activeRouteLeg < maptypes::INVALID_INDEX_VALUE)
+  if(activeRouteLeg < maptypes::INVALID_INDEX_VALUE && activeRouteLeg > 0 && activeRouteLeg < linestring.size())
   {
     // Draw active leg on top of all others to keep it visible
     context->painter->setPen(QPen(OptionData::instance().getFlightplanActiveSegmentColor(), innerlinewidth,
                                   Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
-    ls.clear();
-    ls << linestring.at(activeRouteLeg - 1) << linestring.at(activeRouteLeg);
-    context->painter->drawPolyline(ls);
+    if(useRouteGeometry)
+      drawRouteLeg(context, routeGeometry, activeRouteLeg);
+    else
+    {
+      ls.clear();
+      ls << linestring.at(activeRouteLeg - 1) << linestring.at(activeRouteLeg);
+      context->painter->drawPolyline(ls);
+    }
   }
 
   context->szFont(context->textSizeFlightplan * 1.1f);
@@ -191,6 +217,7 @@ void MapPainterRoute::paintRoute(const PaintContext *context)
   TextPlacement textPlacement(context->painter, this);
   textPlacement.setDrawFast(context->drawFast);
   textPlacement.setLineWidth(outerlinewidth);
+  textPlacement.setRouteGeometry(&routeGeometry);
   textPlacement.calculateTextPositions(positions);
   textPlacement.calculateTextAlongLines(lines, routeTexts);
   context->painter->save();
@@ -218,6 +245,13 @@ void MapPainterRoute::paintRoute(const PaintContext *context)
   drawSymbolText(context, routeMapObjects, visibleStartPoints, textPlacement.getStartPoints());
 }
 
+void MapPainterRoute::drawRouteLeg(const PaintContext *context, const RouteGeometry& routeGeometry, int leg)
+{
+  for(const QPolygonF& polyline : routeGeometry.getLegPolylines(leg))
+    // Bypass GeoPainter which hides the QPainter methods
+    context->painter->QPainter::drawPolyline(polyline);
+}
+
 void MapPainterRoute::paintTopOfDescent(const PaintContext *context)
 {
   const RouteMapObjectList& routeApprMapObjects = routeController->getRouteApprMapObjects();
@@ -770,7 +804,7 @@ void MapPainterRoute::paintApproachPoints(const PaintContext *context, const map
     texts.append(maptypes::altRestrictionTextNarrow(leg.altRestriction));
   }
 
-  const maptypes::MapSearchResult& navaids = leg.navaids;
+  const maptypes::MapApproachNavaids& navaids = leg.navaids;
 
   if(!navaids.waypoints.isEmpty() && wToS(navaids.waypoints.first().position, x, y))
   {
@@ -27,6 +27,7 @@ class GeoDataLineString;
 class MapWidget;
 class RouteController;
 class RouteMapObjectList;
+class RouteGeometry;
 
 /*
  * Draws the flight plan line and all enroute navaid and departure and destination airports (airport symbols only).
@@ -85,6 +86,9 @@ private:
 
   void paintTopOfDescent(const PaintContext *context);
 
+  /* Draw a leg using the cached screen coordinates of the route geometry */
+  void drawRouteLeg(const PaintContext *context, const RouteGeometry& routeGeometry, int leg);
+
 };
 
 #endif // LITTLENAVMAP_MAPPAINTERROUTE_H
@@ -29,11 +29,13 @@
 #include "mapgui/mappainterroute.h"
 #include "mapgui/mapscale.h"
 #include "route/routecontroller.h"
+#include "route/routemapobjectlist.h"
 #include "options/optiondata.h"
 
 #include <QElapsedTimer>
 
 #include <marble/GeoPainter.h>
+#include <marble/ViewportParams.h>
 
 using namespace Marble;
 using namespace atools::geo;
@@ -75,11 +77,13 @@ MapPaintLayer::~MapPaintLayer()
 void MapPaintLayer::preDatabaseLoad()
 {
   databaseLoadStatus = true;
+  invalidateStaticLayer();
 }
 
 void MapPaintLayer::postDatabaseLoad()
 {
   databaseLoadStatus = false;
+  invalidateStaticLayer();
 }
 
 void MapPaintLayer::setShowMapObjects(maptypes::MapObjectTypes type, bool show)
@@ -94,6 +98,7 @@ void MapPaintLayer::setDetailFactor(int factor)
 {
   detailFactor = factor;
   updateLayers();
+  invalidateStaticLayer();
 }
 
 /* Initialize the layer settings that define what is drawn at what zoom distance (text, size, etc.) */
@@ -228,6 +233,48 @@ void MapPaintLayer::initMapLayerSettings()
   qDebug() << *layers;
 }
 
+bool MapPaintLayer::StaticLayerKey::operator==(const StaticLayerKey& other) const
+{
+  return centerLonRad == other.centerLonRad && centerLatRad == other.centerLatRad &&
+         pixelRatio == other.pixelRatio && radius == other.radius && projection == other.projection &&
+         size == other.size && objectTypes == other.objectTypes && mapLayer == other.mapLayer &&
+         mapLayerEffective == other.mapLayerEffective && drawFast == other.drawFast &&
+         activeRouteLeg == other.activeRouteLeg && activeApproachLeg == other.activeApproachLeg;
+}
+
+/* Paint all objects that are not changed by simulator updates */
+void MapPaintLayer::renderStatic(PaintContext *context)
+{
+  if(mapWidget->distance() < DISTANCE_CUT_OFF_LIMIT)
+  {
+    if(context->mapLayerEffective->isAirportDiagram())
+    {
+      // Put ILS below and navaids on top of airport diagram
+      mapPainterIls->render(context);
+
+      if(!context->isOverflow())
+        mapPainterAirport->render(context);
+
+      if(!context->isOverflow())
+        mapPainterNav->render(context);
+    }
+    else
+    {
+      // Airports on top of all
+      if(!context->isOverflow())
+        mapPainterIls->render(context);
+
+      if(!context->isOverflow())
+        mapPainterNav->render(context);
+
+      if(!context->isOverflow())
+        mapPainterAirport->render(context);
+    }
+  }
+  // if(!context->isOverflow()) always paint route even if number of objets is too large
+  mapPainterRoute->render(context);
+}
+
 /* Update the stored layer pointers after zoom distance has changed */
 void MapPaintLayer::updateLayers()
 {
@@ -295,34 +342,62 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport,
 
       context.dispOpts = od.getDisplayOptions();
 
-      if(mapWidget->distance() < DISTANCE_CUT_OFF_LIMIT)
+      if(mapWidget->viewContext() == Marble::Animation || bypassStaticLayer)
+      {
+        // View changes with each frame while scrolling or zooming - no need to cache
+        // Printing renders at a higher resolution than the cached image
+        renderStatic(&context);
+        staticLayerGeneration++;
+      }
+      else
       {
-        if(context.mapLayerEffective->isAirportDiagram())
+        const RouteMapObjectList& routeApprMapObjects =
+          mapWidget->getRouteController()->getRouteApprMapObjects();
+
+        StaticLayerKey key;
+        key.centerLonRad = viewport->centerLongitude();
+        key.centerLatRad = viewport->centerLatitude();
+        key.pixelRatio = painter->device()->devicePixelRatioF();
+        key.radius = viewport->radius();
+        key.projection = viewport->projection();
+        key.size = QSize(painter->device()->width(), painter->device()->height());
+        key.objectTypes = objectTypes;
+        key.mapLayer = mapLayer;
+        key.mapLayerEffective = mapLayerEffective;
+        key.drawFast = context.drawFast;
+        key.activeRouteLeg = routeApprMapObjects.getActiveRouteLeg();
+        key.activeApproachLeg = routeApprMapObjects.getActiveApproachLeg();
+
+        if(!staticLayerValid || key != staticLayerKey)
         {
-          // Put ILS below and navaids on top of airport diagram
-          mapPainterIls->render(&context);
-
-          if(!context.isOverflow())
-            mapPainterAirport->render(&context);
-
-          if(!context.isOverflow())
-            mapPainterNav->render(&context);
+          // Paint airports, navaids, ILS and route into a transparent image
+          staticLayerImage = QImage(static_cast<int>(key.size.width() * key.pixelRatio),
+                                    static_cast<int>(key.size.height() * key.pixelRatio),
+                                    QImage::Format_ARGB32_Premultiplied);
+          staticLayerImage.setDevicePixelRatio(key.pixelRatio);
+          staticLayerImage.fill(Qt::transparent);
+
+          GeoPainter imagePainter(&staticLayerImage, viewport, painter->mapQuality());
+          imagePainter.setRenderHints(painter->renderHints());
+          imagePainter.setFont(context.defaultFont);
+
+          context.painter = &imagePainter;
+          renderStatic(&context);
+          imagePainter.end();
+          context.painter = painter;
+
+          staticLayerKey = key;
+          staticLayerObjectCount = context.objectCount;
+          staticLayerValid = true;
+          staticLayerGeneration++;
         }
         else
-        {
-          // Airports on top of all
-          if(!context.isOverflow())
-            mapPainterIls->render(&context);
-
-          if(!context.isOverflow())
-            mapPainterNav->render(&context);
+          // Nothing changed - keep object count for overflow detection
+          context.objectCount = staticLayerObjectCount;
 
-          if(!context.isOverflow())
-            mapPainterAirport->render(&context);
-        }
+        // Use the QPainter method since GeoPainter hides the screen coordinate overloads
+        static_cast<QPainter *>(painter)->drawImage(QPoint(0, 0), staticLayerImage);
       }
-      // if(!context.isOverflow()) always paint route even if number of objets is too large
-      mapPainterRoute->render(&context);
 
       // if(!context.isOverflow())
       mapPainterMark->render(&context);
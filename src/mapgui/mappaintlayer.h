@@ -21,8 +21,10 @@
 #include "mapgui/mappainter.h"
 
 #include <QPen>
+#include <QImage>
 
 #include <marble/LayerInterface.h>
+#include <marble/MarbleGlobal.h>
 
 namespace Marble {
 class GeoPainter;
@@ -92,10 +94,55 @@ public:
     return overflow;
   }
 
+  /* Forces a new rendering of airports, navaids, ILS and route on the next paint event. Has to be called if
+   * anything besides the view that affects these changes, like route, options or database. */
+  void invalidateStaticLayer()
+  {
+    staticLayerValid = false;
+  }
+
+  /* Changes whenever airports, navaids, ILS and route were painted again because the view or their content
+   * changed. Used to detect changes of the screen index. */
+  quint32 getStaticLayerGeneration() const
+  {
+    return staticLayerGeneration;
+  }
+
+  /* Paint the static layer directly instead of using the cached image. Has to be set while rendering
+   * into a pixmap for printing since the painter device is still the map widget. */
+  void setBypassStaticLayer(bool value)
+  {
+    bypassStaticLayer = value;
+  }
+
 private:
+  /* Values that define the content of the cached static layer image */
+  struct StaticLayerKey
+  {
+    qreal centerLonRad = 0., centerLatRad = 0., pixelRatio = 1.;
+    int radius = 0;
+    Marble::Projection projection = Marble::Spherical;
+    QSize size;
+    maptypes::MapObjectTypes objectTypes = maptypes::NONE;
+    const MapLayer *mapLayer = nullptr, *mapLayerEffective = nullptr;
+    bool drawFast = false;
+    int activeRouteLeg = 0, activeApproachLeg = 0;
+
+    bool operator==(const StaticLayerKey& other) const;
+
+    bool operator!=(const StaticLayerKey& other) const
+    {
+      return !operator==(other);
+    }
+
+  };
+
   void initMapLayerSettings();
   void updateLayers();
 
+  /* Paint all objects that do not change with simulator updates */
+  void renderStatic(PaintContext *context);
+
   /* Implemented from LayerInterface: We  draw above all but below user tools */
   virtual QStringList renderPosition() const override
   {
@@ -134,6 +181,15 @@ private:
   const MapLayer *mapLayer = nullptr, *mapLayerEffective = nullptr;
   int overflow = 0;
 
+  /* Airports, navaids, ILS and route are painted into this image which is reused when only aircraft, track or
+   * marks change */
+  QImage staticLayerImage;
+  StaticLayerKey staticLayerKey;
+  int staticLayerObjectCount = 0;
+  bool staticLayerValid = false;
+  bool bypassStaticLayer = false;
+  quint32 staticLayerGeneration = 0;
+
 };
 
 #endif // LITTLENAVMAP_MAPPAINTLAYER_H
@@ -156,6 +156,14 @@ void MapQuery::getWaypointsForAirway(QList<maptypes::MapWaypoint>& waypoints, co
 void MapQuery::getWaypointListForAirwayName(QList<maptypes::MapAirwayWaypoint>& waypoints,
                                             const QString& airwayName)
 {
+  QList<maptypes::MapAirwayWaypoint> *cached = airwayWaypointCache.object(airwayName);
+  if(cached != nullptr)
+  {
+    waypoints.append(*cached);
+    return;
+  }
+
+  QList<maptypes::MapAirwayWaypoint> airwayWaypoints;
   airwayWaypointsQuery->bindValue(":name", airwayName);
   airwayWaypointsQuery->exec();
 
@@ -186,7 +194,7 @@ void MapQuery::getWaypointListForAirwayName(QList<maptypes::MapAirwayWaypoint>&
       aw.waypoint = result.waypoints.first();
     else
       qWarning() << "getWaypointListForAirwayName: no waypoint for" << airwayName << "wp id" << fromId;
-    waypoints.append(aw);
+    airwayWaypoints.append(aw);
 
     if(i == records.size() - 1 || fragment != nextFragment)
     {
@@ -198,9 +206,12 @@ void MapQuery::getWaypointListForAirwayName(QList<maptypes::MapAirwayWaypoint>&
         aw.waypoint = result.waypoints.first();
       else
         qWarning() << "getWaypointListForAirwayName: no waypoint for" << airwayName << "wp id" << toId;
-      waypoints.append(aw);
+      airwayWaypoints.append(aw);
     }
   }
+
+  airwayWaypointCache.insert(airwayName, new QList<maptypes::MapAirwayWaypoint>(airwayWaypoints));
+  waypoints.append(airwayWaypoints);
 }
 
 void MapQuery::getAirwayById(maptypes::MapAirway& airway, int airwayId)
@@ -280,6 +291,100 @@ void MapQuery::getMapObjectByIdent(maptypes::MapSearchResult& result, maptypes::
   }
 }
 
+void MapQuery::getMapObjectsByIdents(QHash<QString, maptypes::MapSearchResult>& results,
+                                     maptypes::MapObjectTypes type, const QStringList& idents)
+{
+  QStringList uniqueIdents = idents;
+  uniqueIdents.removeDuplicates();
+
+  for(int start = 0; start < uniqueIdents.size(); start += QUERY_MAX_IDENTS)
+  {
+    QStringList chunk = uniqueIdents.mid(start, QUERY_MAX_IDENTS);
+
+    // Build list of bind variables for the in clause
+    QStringList binds;
+    for(int i = 0; i < chunk.size(); i++)
+      binds.append(QString(":i%1").arg(i));
+    QString in("in (" + binds.join(",") + ")");
+
+    // No need to create permanent queries here since they are called rarely
+    if(type & maptypes::AIRPORT)
+    {
+      SqlQuery query(db);
+      query.prepare("select * from airport where ident " + in);
+      for(int i = 0; i < chunk.size(); i++)
+        query.bindValue(binds.at(i), chunk.at(i));
+      query.exec();
+      while(query.next())
+      {
+        maptypes::MapAirport ap;
+        mapTypesFactory->fillAirport(query.record(), ap, true);
+        results[ap.ident].airports.append(ap);
+      }
+    }
+
+    if(type & maptypes::VOR)
+    {
+      SqlQuery query(db);
+      query.prepare("select * from vor where ident " + in);
+      for(int i = 0; i < chunk.size(); i++)
+        query.bindValue(binds.at(i), chunk.at(i));
+      query.exec();
+      while(query.next())
+      {
+        maptypes::MapVor vor;
+        mapTypesFactory->fillVor(query.record(), vor);
+        results[vor.ident].vors.append(vor);
+      }
+    }
+
+    if(type & maptypes::NDB)
+    {
+      SqlQuery query(db);
+      query.prepare("select * from ndb where ident " + in);
+      for(int i = 0; i < chunk.size(); i++)
+        query.bindValue(binds.at(i), chunk.at(i));
+      query.exec();
+      while(query.next())
+      {
+        maptypes::MapNdb ndb;
+        mapTypesFactory->fillNdb(query.record(), ndb);
+        results[ndb.ident].ndbs.append(ndb);
+      }
+    }
+
+    if(type & maptypes::WAYPOINT)
+    {
+      SqlQuery query(db);
+      query.prepare("select * from waypoint where ident " + in);
+      for(int i = 0; i < chunk.size(); i++)
+        query.bindValue(binds.at(i), chunk.at(i));
+      query.exec();
+      while(query.next())
+      {
+        maptypes::MapWaypoint wp;
+        mapTypesFactory->fillWaypoint(query.record(), wp);
+        results[wp.ident].waypoints.append(wp);
+      }
+    }
+
+    if(type & maptypes::AIRWAY)
+    {
+      SqlQuery query(db);
+      query.prepare("select * from airway where airway_name " + in);
+      for(int i = 0; i < chunk.size(); i++)
+        query.bindValue(binds.at(i), chunk.at(i));
+      query.exec();
+      while(query.next())
+      {
+        maptypes::MapAirway airway;
+        mapTypesFactory->fillAirway(query.record(), airway);
+        results[airway.name].airways.append(airway);
+      }
+    }
+  }
+}
+
 void MapQuery::getMapObjectById(maptypes::MapSearchResult& result, maptypes::MapObjectTypes type, int id)
 {
   if(type == maptypes::AIRPORT)
@@ -385,6 +490,21 @@ maptypes::MapRunwayEnd MapQuery::getRunwayEndById(int id)
   return end;
 }
 
+/* Convert the positions of all objects in the list to screen coordinates at once */
+template<typename TYPE>
+static QVector<QPoint> screenPositions(const CoordinateConverter& conv, const QList<TYPE>& list,
+                                       QVector<bool>& visible)
+{
+  QVector<atools::geo::Pos> positions;
+  positions.reserve(list.size());
+  for(const TYPE& obj : list)
+    positions.append(obj.position);
+
+  QVector<QPoint> points;
+  conv.wToS(positions, points, &visible);
+  return points;
+}
+
 void MapQuery::getNearestObjects(const CoordinateConverter& conv, const MapLayer *mapLayer,
                                  bool airportDiagram, maptypes::MapObjectTypes types,
                                  int xs, int ys, int screenDistance,
@@ -392,25 +512,29 @@ void MapQuery::getNearestObjects(const CoordinateConverter& conv, const MapLayer
 {
   using maptools::insertSortedByDistance;
   using maptools::insertSortedByTowerDistance;
+  using atools::geo::manhattanDistance;
+
+  QVector<QPoint> points;
+  QVector<bool> visible;
 
   int x, y;
   if(mapLayer->isAirport() && types.testFlag(maptypes::AIRPORT))
   {
+    points = screenPositions(conv, airportCache.list, visible);
     for(int i = airportCache.list.size() - 1; i >= 0; i--)
     {
       const MapAirport& airport = airportCache.list.at(i);
 
       if(airport.isVisible(types))
       {
-        if(conv.wToS(airport.position, x, y))
-          if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
-            insertSortedByDistance(conv, result.airports, &result.airportIds, xs, ys, airport);
+        if(visible.at(i) && manhattanDistance(points.at(i).x(), points.at(i).y(), xs, ys) < screenDistance)
+          insertSortedByDistance(conv, result.airports, &result.airportIds, xs, ys, airport);
 
         if(airportDiagram)
         {
           // Include tower for airport diagrams
           if(conv.wToS(airport.towerCoords, x, y) &&
-             atools::geo::manhattanDistance(x, y, xs, ys) < screenDistance)
+             manhattanDistance(x, y, xs, ys) < screenDistance)
             insertSortedByTowerDistance(conv, result.towers, xs, ys, airport);
         }
       }
@@ -419,69 +543,69 @@ void MapQuery::getNearestObjects(const CoordinateConverter& conv, const MapLayer
 
   if(mapLayer->isVor() && types.testFlag(maptypes::VOR))
   {
+    points = screenPositions(conv, vorCache.list, visible);
     for(int i = vorCache.list.size() - 1; i >= 0; i--)
     {
-      const MapVor& vor = vorCache.list.at(i);
-      if(conv.wToS(vor.position, x, y))
-        if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
-          insertSortedByDistance(conv, result.vors, &result.vorIds, xs, ys, vor);
+      if(visible.at(i) && manhattanDistance(points.at(i).x(), points.at(i).y(), xs, ys) < screenDistance)
+        insertSortedByDistance(conv, result.vors, &result.vorIds, xs, ys, vorCache.list.at(i));
     }
   }
 
   if(mapLayer->isNdb() && types.testFlag(maptypes::NDB))
   {
+    points = screenPositions(conv, ndbCache.list, visible);
     for(int i = ndbCache.list.size() - 1; i >= 0; i--)
     {
-      const MapNdb& ndb = ndbCache.list.at(i);
-      if(conv.wToS(ndb.position, x, y))
-        if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
-          insertSortedByDistance(conv, result.ndbs, &result.ndbIds, xs, ys, ndb);
+      if(visible.at(i) && manhattanDistance(points.at(i).x(), points.at(i).y(), xs, ys) < screenDistance)
+        insertSortedByDistance(conv, result.ndbs, &result.ndbIds, xs, ys, ndbCache.list.at(i));
     }
   }
 
-  if(mapLayer->isWaypoint() && types.testFlag(maptypes::WAYPOINT))
+  bool waypoints = mapLayer->isWaypoint() && types.testFlag(maptypes::WAYPOINT);
+  if(waypoints || mapLayer->isAirway())
   {
-    for(int i = waypointCache.list.size() - 1; i >= 0; i--)
+    // Waypoint positions are used for both waypoints and airways
+    points = screenPositions(conv, waypointCache.list, visible);
+
+    if(waypoints)
     {
-      const MapWaypoint& wp = waypointCache.list.at(i);
-      if(conv.wToS(wp.position, x, y))
-        if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
-          insertSortedByDistance(conv, result.waypoints, &result.waypointIds, xs, ys, wp);
+      for(int i = waypointCache.list.size() - 1; i >= 0; i--)
+      {
+        if(visible.at(i) && manhattanDistance(points.at(i).x(), points.at(i).y(), xs, ys) < screenDistance)
+          insertSortedByDistance(conv, result.waypoints, &result.waypointIds, xs, ys, waypointCache.list.at(i));
+      }
     }
-  }
 
-  if(mapLayer->isAirway())
-  {
-    for(int i = waypointCache.list.size() - 1; i >= 0; i--)
+    if(mapLayer->isAirway())
     {
-      const MapWaypoint& wp = waypointCache.list.at(i);
-      if((wp.hasVictorAirways && types.testFlag(maptypes::AIRWAYV)) ||
-         (wp.hasJetAirways && types.testFlag(maptypes::AIRWAYJ)))
-        if(conv.wToS(wp.position, x, y))
-          if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
+      for(int i = waypointCache.list.size() - 1; i >= 0; i--)
+      {
+        const MapWaypoint& wp = waypointCache.list.at(i);
+        if((wp.hasVictorAirways && types.testFlag(maptypes::AIRWAYV)) ||
+           (wp.hasJetAirways && types.testFlag(maptypes::AIRWAYJ)))
+          if(visible.at(i) && manhattanDistance(points.at(i).x(), points.at(i).y(), xs, ys) < screenDistance)
             insertSortedByDistance(conv, result.waypoints, &result.waypointIds, xs, ys, wp);
+      }
     }
   }
 
   if(mapLayer->isMarker() && types.testFlag(maptypes::MARKER))
   {
+    points = screenPositions(conv, markerCache.list, visible);
     for(int i = markerCache.list.size() - 1; i >= 0; i--)
     {
-      const MapMarker& wp = markerCache.list.at(i);
-      if(conv.wToS(wp.position, x, y))
-        if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
-          insertSortedByDistance(conv, result.markers, nullptr, xs, ys, wp);
+      if(visible.at(i) && manhattanDistance(points.at(i).x(), points.at(i).y(), xs, ys) < screenDistance)
+        insertSortedByDistance(conv, result.markers, nullptr, xs, ys, markerCache.list.at(i));
     }
   }
 
   if(mapLayer->isIls() && types.testFlag(maptypes::ILS))
   {
+    points = screenPositions(conv, ilsCache.list, visible);
     for(int i = ilsCache.list.size() - 1; i >= 0; i--)
     {
-      const MapIls& wp = ilsCache.list.at(i);
-      if(conv.wToS(wp.position, x, y))
-        if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
-          insertSortedByDistance(conv, result.ils, nullptr, xs, ys, wp);
+      if(visible.at(i) && manhattanDistance(points.at(i).x(), points.at(i).y(), xs, ys) < screenDistance)
+        insertSortedByDistance(conv, result.ils, nullptr, xs, ys, ilsCache.list.at(i));
     }
   }
 
@@ -1335,6 +1459,7 @@ void MapQuery::deInitQueries()
   parkingCache.clear();
   startCache.clear();
   helipadCache.clear();
+  airwayWaypointCache.clear();
 
   delete airportByRectQuery;
   airportByRectQuery = nullptr;
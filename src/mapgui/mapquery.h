@@ -22,6 +22,7 @@
 #include "mapgui/maplayer.h"
 
 #include <QCache>
+#include <QHash>
 #include <QList>
 
 #include <marble/GeoDataLatLonBox.h>
@@ -69,7 +70,7 @@ public:
   void getWaypointsForAirway(QList<maptypes::MapWaypoint>& waypoints, const QString& airwayName,
                              const QString& waypointIdent = QString());
 
-  /* Get all waypoints or an airway ordered by fragment an sequence number */
+  /* Get all waypoints or an airway ordered by fragment an sequence number. Lists are cached by airway name. */
   void getWaypointListForAirwayName(QList<maptypes::MapAirwayWaypoint>& waypoints, const QString& airwayName);
 
   void getAirwayById(maptypes::MapAirway& airway, int airwayId);
@@ -99,6 +100,16 @@ public:
   void getMapObjectByIdent(maptypes::MapSearchResult& result, maptypes::MapObjectTypes type,
                            const QString& ident, const QString& region = QString());
 
+  /*
+   * Get map objects for a list of idents with only one query per type. Used to resolve all items of a
+   * route string at once.
+   * @param results will receive objects for each ident keyed by ident. Idents that were not found are not inserted.
+   * @param type AIRPORT, VOR, NDB, WAYPOINT or AIRWAY
+   * @param idents ICAO idents or airway names
+   */
+  void getMapObjectsByIdents(QHash<QString, maptypes::MapSearchResult>& results, maptypes::MapObjectTypes type,
+                             const QStringList& idents);
+
   /*
    * Get a map object by type and id
    * @param result will receive objects based on type
@@ -257,11 +268,17 @@ private:
   QCache<int, QList<maptypes::MapStart> > startCache;
   QCache<int, QList<maptypes::MapHelipad> > helipadCache;
 
+  /* Airway name to all airway waypoints ordered by fragment and sequence number */
+  QCache<QString, QList<maptypes::MapAirwayWaypoint> > airwayWaypointCache;
+
   /* Inflate bounding rectangle before passing it to query */
   static Q_DECL_CONSTEXPR double RECT_INFLATION_FACTOR_DEG = 0.3;
   static Q_DECL_CONSTEXPR double RECT_INFLATION_ADD_DEG = 0.1;
   static Q_DECL_CONSTEXPR int QUERY_ROW_LIMIT = 5000;
 
+  /* Maximum number of bind variables in one "in" clause for getMapObjectsByIdents. SQLite limit is 999. */
+  static Q_DECL_CONSTEXPR int QUERY_MAX_IDENTS = 500;
+
   /* Database queries */
   atools::sql::SqlQuery *airportByRectQuery = nullptr, *airportMediumByRectQuery = nullptr,
   *airportLargeByRectQuery = nullptr;
@@ -77,13 +77,20 @@ void MapScreenIndex::updateAirwayScreenGeometry(const Marble::GeoDataLatLonAltBo
         float numSegments = std::min(std::max(scale->getPixelIntForMeter(distanceMeter) / 40.f, 2.f), 72.f);
         float step = 1.f / numSegments;
 
-        // Split the segments into smaller lines and add them only if visible
+        // Split the segment into a polyline and convert all points at once
+        QVector<Pos> positions;
+        positions.append(airway.from);
         for(int j = 0; j < numSegments; j++)
+          positions.append(airway.from.interpolate(airway.to, distanceMeter, step * static_cast<float>(j + 1)));
+
+        QVector<QPoint> points;
+        conv.wToS(positions, points);
+
+        // Add lines only if visible
+        for(int j = 1; j < points.size(); j++)
         {
-          float cur = step * static_cast<float>(j);
-          int xs1, ys1, xs2, ys2;
-          conv.wToS(airway.from.interpolate(airway.to, distanceMeter, cur), xs1, ys1);
-          conv.wToS(airway.from.interpolate(airway.to, distanceMeter, cur + step), xs2, ys2);
+          int xs1 = points.at(j - 1).x(), ys1 = points.at(j - 1).y();
+          int xs2 = points.at(j).x(), ys2 = points.at(j).y();
 
           QRect rect(QPoint(xs1, ys1), QPoint(xs2, ys2));
           rect = rect.normalized();
@@ -128,10 +135,14 @@ void MapScreenIndex::updateRouteScreenGeometry()
   const MapScale *scale = paintLayer->getMapScale();
   if(scale->isValid())
   {
-    Pos p1;
     const QRect& mapGeo = mapWidget->rect();
 
-    for(int i = 0; i < routeMapObjects.getApproachStartIndex(); i++)
+    // Use the same interpolated and projected legs as the route painter
+    RouteGeometry& routeGeometry = mapWidget->getRouteController()->getRouteGeometry();
+    routeGeometry.updateRoute(routeMapObjects);
+    routeGeometry.updateScreen(conv);
+
+    for(int i = 0; i < routeGeometry.size(); i++)
     {
       const Pos& p2 = routeMapObjects.at(i).getPosition();
       maptypes::MapObjectTypes type = routeMapObjects.at(i).getMapObjectType();
@@ -144,31 +155,25 @@ void MapScreenIndex::updateRouteScreenGeometry()
       else
         otherPoints.append(std::make_pair(i, QPoint(x2, y2)));
 
-      if(p1.isValid())
+      if(i > 0)
       {
-        float distanceMeter = p2.distanceMeterTo(p1);
-        // Approximate the needed number of line segments
-        float numSegments = std::min(std::max(scale->getPixelIntForMeter(distanceMeter) / 140.f, 4.f), 288.f);
-        float step = 1.f / numSegments;
-
-        // Split the legs into smaller lines and add them only if visible
-        for(int j = 0; j < numSegments; j++)
+        // Add the smaller lines of the leg only if visible
+        for(const QPolygonF& polyline : routeGeometry.getLegPolylines(i))
         {
-          float cur = step * static_cast<float>(j);
-          int xs1, ys1, xs2, ys2;
-          conv.wToS(p1.interpolate(p2, distanceMeter, cur), xs1, ys1);
-          conv.wToS(p1.interpolate(p2, distanceMeter, cur + step), xs2, ys2);
-
-          QRect rect(QPoint(xs1, ys1), QPoint(xs2, ys2));
-          rect = rect.normalized();
-          // Avoid points or flat rectangles (lines)
-          rect.adjust(-1, -1, 1, 1);
-
-          if(mapGeo.intersects(rect))
-            routeLines.append(std::make_pair(i - 1, QLine(xs1, ys1, xs2, ys2)));
+          for(int j = 1; j < polyline.size(); j++)
+          {
+            QLine line = QLineF(polyline.at(j - 1), polyline.at(j)).toLine();
+
+            QRect rect(line.p1(), line.p2());
+            rect = rect.normalized();
+            // Avoid points or flat rectangles (lines)
+            rect.adjust(-1, -1, 1, 1);
+
+            if(mapGeo.intersects(rect))
+              routeLines.append(std::make_pair(i - 1, line));
+          }
         }
       }
-      p1 = p2;
     }
 
     routePoints.append(airportPoints);
@@ -199,10 +204,12 @@ void MapScreenIndex::getAllNearest(int xs, int ys, int maxDistance, maptypes::Ma
   {
     using maptools::insertSortedByDistance;
     int x, y;
-    for(const atools::fs::sc::SimConnectAircraft& obj : simData.getAiAircraft())
+    // Use the same moved positions as the painter
+    for(int i = 0; i < aiTraffic.size(); i++)
     {
+      const atools::fs::sc::SimConnectAircraft& obj = aiTraffic.at(i);
       if(mapLayerEffective->isAirportDiagram() || !obj.isOnGround())
-        if(conv.wToS(obj.getPosition(), x, y))
+        if(conv.wToS(aiTraffic.getExtrapolatedPosition(i), x, y))
           if((atools::geo::manhattanDistance(x, y, xs, ys)) < maxDistance)
             insertSortedByDistance(conv, result.aiAircraft, nullptr, xs, ys, obj);
     }
@@ -286,11 +293,6 @@ void MapScreenIndex::getNearestApproachHighlights(int xs, int ys, int maxDistanc
        (!(mapWidget->getShownMapFeatures() & maptypes::APPROACH_TRANSITION) && approachHighlight.isTransition(i)))
       continue;
 
-    for(const maptypes::MapAirport& obj : leg.navaids.airports)
-      if(conv.wToS(obj.position, x, y))
-        if((atools::geo::manhattanDistance(x, y, xs, ys)) < maxDistance)
-          insertSortedByDistance(conv, result.airports, &result.airportIds, xs, ys, obj);
-
     for(const maptypes::MapVor& obj : leg.navaids.vors)
       if(conv.wToS(obj.position, x, y))
         if((atools::geo::manhattanDistance(x, y, xs, ys)) < maxDistance)
@@ -21,6 +21,7 @@
 #include "fs/sc/simconnectdata.h"
 
 #include "route/routemapobjectlist.h"
+#include "common/aitraffic.h"
 
 namespace maptypes {
 struct MapSearchResult;
@@ -149,11 +150,23 @@ public:
     return simData.getAiAircraft();
   }
 
+  /* AI and multiplayer aircraft indexed by position */
+  const AiTraffic& getAiTraffic() const
+  {
+    return aiTraffic;
+  }
+
   void updateSimData(const atools::fs::sc::SimConnectData& data)
   {
     simData = data;
   }
 
+  /* Rebuild the AI index from the current simulator data. Called only for packets that are shown on the map. */
+  void updateAiTraffic()
+  {
+    aiTraffic.update(simData.getAiAircraft());
+  }
+
   void updateLastSimData(const atools::fs::sc::SimConnectData& data)
   {
     lastSimData = data;
@@ -175,6 +188,7 @@ private:
   void getNearestApproachHighlights(int xs, int ys, int maxDistance, maptypes::MapSearchResult& result);
 
   atools::fs::sc::SimConnectData simData, lastSimData;
+  AiTraffic aiTraffic;
   MapWidget *mapWidget;
   MapQuery *mapQuery;
   MapPaintLayer *paintLayer;
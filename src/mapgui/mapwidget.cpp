@@ -47,6 +47,7 @@
 #include <QRubberBand>
 #include <QMessageBox>
 #include <QPainter>
+#include <QtConcurrent/QtConcurrentRun>
 
 #include <marble/MarbleLocale.h>
 #include <marble/MarbleWidgetInputHandler.h>
@@ -58,6 +59,9 @@
 // Default zoom distance if start position was not set (usually first start after installation */
 const int DEFAULT_MAP_DISTANCE = 7000;
 
+// Size of the screen cells in pixel used to skip the nearest search for tooltips
+const int TOOLTIP_CELL_SIZE = 4;
+
 // Update rates defined by delta values
 const static QHash<opts::SimUpdateRate, MapWidget::SimUpdateDelta> SIM_UPDATE_DELTA_MAP(
   {
@@ -115,6 +119,9 @@ MapWidget::MapWidget(MainWindow *parent, MapQuery *query)
   screenSearchDistance = OptionData::instance().getMapClickSensitivity();
   screenSearchDistanceTooltip = OptionData::instance().getMapTooltipSensitivity();
 
+  aiInterpolationTimer.setInterval(AI_INTERPOLATION_INTERVAL_MS);
+  connect(&aiInterpolationTimer, &QTimer::timeout, this, &MapWidget::aiInterpolationTimeout);
+
   // "Compass" id "compass"
   // "License" id "license"
   // "Scale Bar" id "scalebar"
@@ -196,6 +203,9 @@ void MapWidget::optionsChanged()
   screenSearchDistance = OptionData::instance().getMapClickSensitivity();
   screenSearchDistanceTooltip = OptionData::instance().getMapTooltipSensitivity();
 
+  // Colors, sizes and units might have changed
+  paintLayer->invalidateStaticLayer();
+
   updateCacheSizes();
 }
 
@@ -325,6 +335,20 @@ void MapWidget::getRouteDragPoints(atools::geo::Pos& from, atools::geo::Pos& to,
   cur = routeDragCur;
 }
 
+void MapWidget::setAlternativeRoutes(const QList<atools::geo::LineString>& routes, int selected)
+{
+  alternativeRoutes = routes;
+  alternativeRouteSelected = selected;
+  update();
+}
+
+void MapWidget::clearAlternativeRoutes()
+{
+  alternativeRoutes.clear();
+  alternativeRouteSelected = -1;
+  update();
+}
+
 void MapWidget::preDatabaseLoad()
 {
   cancelDragAll();
@@ -398,6 +422,7 @@ void MapWidget::saveState()
 
   history.saveState(atools::settings::Settings::getConfigFilename(".history"));
   screenIndex->saveState();
+  takeAircraftTrack();
   aircraftTrack.saveState();
 
   overlayStateToMenu();
@@ -439,7 +464,11 @@ void MapWidget::restoreState()
   if(OptionData::instance().getFlags() & opts::STARTUP_LOAD_KML)
     kmlFilePaths = s.valueStrList(lnm::MAP_KMLFILES);
   screenIndex->restoreState();
-  aircraftTrack.restoreState();
+
+  // Read the track file while the rest of the application is set up
+  aircraftTrack.clearTrack();
+  aircraftTrackFuture = QtConcurrent::run(&AircraftTrack::loadTrackThread, AircraftTrack::getTrackFilename());
+  aircraftTrackLoading = true;
 
   atools::gui::WidgetState state(lnm::MAP_OVERLAY_VISIBLE, false /*save visibility*/, true /*block signals*/);
   for(QAction *action : mapOverlays.values())
@@ -481,6 +510,22 @@ void MapWidget::showOverlays(bool show)
   }
 }
 
+QPixmap MapWidget::renderMapImage(double scale, const QRect& sourceRect)
+{
+  QRect source = sourceRect.isValid() ? sourceRect : rect();
+
+  // Pixel ratio lets the painter scale all drawing operations
+  QPixmap pixmap(source.size() * scale);
+  pixmap.setDevicePixelRatio(scale);
+  pixmap.fill(QGuiApplication::palette().color(QPalette::Window));
+
+  // Redirected painter device is still the widget - draw all objects at the higher resolution
+  paintLayer->setBypassStaticLayer(true);
+  render(&pixmap, QPoint(), QRegion(source));
+  paintLayer->setBypassStaticLayer(false);
+  return pixmap;
+}
+
 void MapWidget::overlayStateToMenu()
 {
   qDebug() << Q_FUNC_INFO;
@@ -547,6 +592,9 @@ void MapWidget::mainWindowShown()
 {
   qDebug() << Q_FUNC_INFO;
 
+  // Track has to be available before connecting to the simulator
+  takeAircraftTrack();
+
   // Create a copy of KML files where all missing files will be removed from the recent list
   QStringList copyKml(kmlFilePaths);
   for(const QString& kml : kmlFilePaths)
@@ -741,6 +789,8 @@ void MapWidget::changeRouteHighlights(const QList<int>& routeHighlight)
 
 void MapWidget::routeChanged(bool geometryChanged)
 {
+  paintLayer->invalidateStaticLayer();
+
   if(geometryChanged)
   {
     cancelDragAll();
@@ -790,21 +840,27 @@ void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorDa
     {
       lastSimUpdateMs = now;
 
-      // Check if any AI aircraft are visible
+      // Index only packets that are shown
+      screenIndex->updateAiTraffic();
+
+      // Check if any AI aircraft are visible using the grid
       bool aiVisible = false;
       if(paintLayer->getShownMapObjects() & maptypes::AIRCRAFT_AI)
+        aiVisible = screenIndex->getAiTraffic().hasAircraftInRect(
+          Rect(currentViewBoundingBox.west(GeoDataCoordinates::Degree),
+               currentViewBoundingBox.north(GeoDataCoordinates::Degree),
+               currentViewBoundingBox.east(GeoDataCoordinates::Degree),
+               currentViewBoundingBox.south(GeoDataCoordinates::Degree)));
+
+      // Move AI smoothly between packets but only if the user allows fast updates and any aircraft is moving
+      if(aiVisible && screenIndex->getAiTraffic().isExtrapolating() &&
+         OptionData::instance().getSimUpdateRate() == opts::FAST)
       {
-        for(const atools::fs::sc::SimConnectAircraft& ai : simulatorData.getAiAircraft())
-        {
-          if(currentViewBoundingBox.contains(
-               Marble::GeoDataCoordinates(ai.getPosition().getLonX(), ai.getPosition().getLatY(), 0,
-                                          Marble::GeoDataCoordinates::Degree)))
-          {
-            aiVisible = true;
-            break;
-          }
-        }
+        if(!aiInterpolationTimer.isActive())
+          aiInterpolationTimer.start();
       }
+      else
+        aiInterpolationTimer.stop();
 
       using atools::almostNotEqual;
       if(!lastUserAircraft.getPosition().isValid() ||
@@ -852,6 +908,18 @@ void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorDa
   }
 }
 
+/* Repaint to show dead-reckoned AI positions between simulator packets */
+void MapWidget::aiInterpolationTimeout()
+{
+  if(!(paintLayer->getShownMapObjects() & maptypes::AIRCRAFT_AI) || !isConnected() ||
+     !screenIndex->getAiTraffic().isExtrapolating())
+    // Nothing to move until the next packet arrives
+    aiInterpolationTimer.stop();
+  else if(!databaseLoadStatus && mouseState == mw::NONE && viewContext() == Marble::Still &&
+          distance() < MAX_AI_INTERPOLATION_DISTANCE)
+    update();
+}
+
 void MapWidget::highlightProfilePoint(const atools::geo::Pos& pos)
 {
   if(pos.isValid())
@@ -890,8 +958,11 @@ void MapWidget::connectedToSimulator()
 void MapWidget::disconnectedFromSimulator()
 {
   qDebug() << Q_FUNC_INFO;
+  aiInterpolationTimer.stop();
+
   // Clear all data on disconnect
   screenIndex->updateSimData(atools::fs::sc::SimConnectData());
+  screenIndex->updateAiTraffic();
   update();
 }
 
@@ -936,6 +1007,7 @@ void MapWidget::changeApproachHighlight(const maptypes::MapApproachLegs& approac
   cancelDragAll();
   screenIndex->getApproachHighlight() = approach;
   screenIndex->updateRouteScreenGeometry();
+  paintLayer->invalidateStaticLayer();
   update();
 }
 
@@ -2141,17 +2213,69 @@ void MapWidget::showTooltip(bool update)
   if(update && !QToolTip::isVisible())
     return;
 
-  // Build a new tooltip HTML for weather changes or aircraft updates
-  QString text = mapTooltip->buildTooltip(mapSearchResultTooltip,
-                                          mainWindow->getRouteController()->getRouteApprMapObjects(),
-                                          paintLayer->getMapLayer()->isAirportDiagram());
+  bool airportDiagram = paintLayer->getMapLayer()->isAirportDiagram();
+
+  QVector<int> objectIds;
+  bool hasIds = tooltipIds(mapSearchResultTooltip, objectIds);
+  quint32 generation = paintLayer->getStaticLayerGeneration();
 
-  if(!text.isEmpty() && !tooltipPos.isNull())
-    QToolTip::showText(tooltipPos, text /*, nullptr, QRect(), 3600 * 1000*/);
+  // Reuse the HTML if the cursor is still over the same objects and neither view nor route have changed
+  if(update || !hasIds || objectIds != tooltipObjectIds || generation != tooltipTextGeneration ||
+     airportDiagram != tooltipAirportDiagram)
+  {
+    // Build a new tooltip HTML for weather changes or aircraft updates
+    tooltipText = mapTooltip->buildTooltip(mapSearchResultTooltip,
+                                           mainWindow->getRouteController()->getRouteApprMapObjects(),
+                                           airportDiagram);
+    tooltipObjectIds = hasIds ? objectIds : QVector<int>();
+    tooltipTextGeneration = generation;
+    tooltipAirportDiagram = airportDiagram;
+  }
+
+  if(!tooltipText.isEmpty() && !tooltipPos.isNull())
+    QToolTip::showText(tooltipPos, tooltipText /*, nullptr, QRect(), 3600 * 1000*/);
   else
     hideTooltip();
 }
 
+bool MapWidget::tooltipIds(const maptypes::MapSearchResult& result, QVector<int>& ids)
+{
+  // Aircraft are moving and approach points or helipads have no id - these cannot be reused
+  if(result.userAircraft.getPosition().isValid() || !result.aiAircraft.isEmpty() ||
+     !result.approachPoints.isEmpty() || !result.helipads.isEmpty())
+    return false;
+
+  // Add the number of objects for each type as separator
+  ids.append(result.airports.size());
+  for(const maptypes::MapAirport& obj : result.airports)
+    ids.append(obj.id);
+  ids.append(result.vors.size());
+  for(const maptypes::MapVor& obj : result.vors)
+    ids.append(obj.id);
+  ids.append(result.ndbs.size());
+  for(const maptypes::MapNdb& obj : result.ndbs)
+    ids.append(obj.id);
+  ids.append(result.waypoints.size());
+  for(const maptypes::MapWaypoint& obj : result.waypoints)
+    ids.append(obj.id);
+  ids.append(result.airways.size());
+  for(const maptypes::MapAirway& obj : result.airways)
+    ids.append(obj.id);
+  ids.append(result.markers.size());
+  for(const maptypes::MapMarker& obj : result.markers)
+    ids.append(obj.id);
+  ids.append(result.towers.size());
+  for(const maptypes::MapAirport& obj : result.towers)
+    ids.append(obj.id);
+  ids.append(result.parkings.size());
+  for(const maptypes::MapParking& obj : result.parkings)
+    ids.append(obj.id);
+  ids.append(result.userPoints.size());
+  for(const maptypes::MapUserpoint& obj : result.userPoints)
+    ids.append(obj.id);
+  return true;
+}
+
 const atools::fs::sc::SimConnectUserAircraft& MapWidget::getUserAircraft() const
 {
   return screenIndex->getUserAircraft();
@@ -2162,13 +2286,29 @@ const QVector<atools::fs::sc::SimConnectAircraft>& MapWidget::getAiAircraft() co
   return screenIndex->getAiAircraft();
 }
 
+const AiTraffic& MapWidget::getAiTraffic() const
+{
+  return screenIndex->getAiTraffic();
+}
+
 bool MapWidget::isConnected() const
 {
   return mainWindow->getConnectClient()->isConnected();
 }
 
+void MapWidget::takeAircraftTrack()
+{
+  if(aircraftTrackLoading)
+  {
+    aircraftTrack = aircraftTrackFuture.result();
+    aircraftTrackLoading = false;
+    qDebug() << Q_FUNC_INFO << "Loaded" << aircraftTrack.size() << "track points";
+  }
+}
+
 void MapWidget::deleteAircraftTrack()
 {
+  takeAircraftTrack();
   aircraftTrack.clearTrack();
   emit updateActionStates();
   update();
@@ -2181,10 +2321,21 @@ bool MapWidget::event(QEvent *event)
   {
     QHelpEvent *helpEvent = static_cast<QHelpEvent *>(event);
 
-    // Load tooltip data into mapSearchResultTooltip
-    mapSearchResultTooltip = maptypes::MapSearchResult();
-    screenIndex->getAllNearest(helpEvent->pos().x(), helpEvent->pos().y(), screenSearchDistanceTooltip,
-                               mapSearchResultTooltip);
+    // Skip the search if the cursor is still in the same cell and the map objects did not change
+    // Aircraft move all the time and require a new search
+    QPoint cell(helpEvent->pos().x() / TOOLTIP_CELL_SIZE, helpEvent->pos().y() / TOOLTIP_CELL_SIZE);
+    quint32 generation = paintLayer->getStaticLayerGeneration();
+    bool hasAircraft = mapSearchResultTooltip.userAircraft.getPosition().isValid() ||
+                       !mapSearchResultTooltip.aiAircraft.isEmpty();
+    if(cell != tooltipCell || generation != tooltipSearchGeneration || hasAircraft || tooltipPos.isNull())
+    {
+      // Load tooltip data into mapSearchResultTooltip
+      mapSearchResultTooltip = maptypes::MapSearchResult();
+      screenIndex->getAllNearest(helpEvent->pos().x(), helpEvent->pos().y(), screenSearchDistanceTooltip,
+                                 mapSearchResultTooltip);
+      tooltipCell = cell;
+      tooltipSearchGeneration = generation;
+    }
     tooltipPos = helpEvent->globalPos();
 
     // Build HTML
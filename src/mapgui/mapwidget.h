@@ -24,6 +24,8 @@
 #include "common/aircrafttrack.h"
 
 #include <QWidget>
+#include <QTimer>
+#include <QFuture>
 
 #include <marble/GeoDataLatLonAltBox.h>
 #include <marble/MarbleWidget.h>
@@ -44,6 +46,7 @@ class MapPaintLayer;
 class MapQuery;
 class RouteController;
 class MapTooltip;
+class AiTraffic;
 class QRubberBand;
 class MapScreenIndex;
 class RouteMapObjectList;
@@ -160,6 +163,21 @@ public:
    * if dragging departure or destination */
   void getRouteDragPoints(atools::geo::Pos& from, atools::geo::Pos& to, QPoint& cur);
 
+  /* Show calculated alternative routes as a temporary overlay while the user selects one.
+   * selected is the index of the highlighted route or -1 */
+  void setAlternativeRoutes(const QList<atools::geo::LineString>& routes, int selected);
+  void clearAlternativeRoutes();
+
+  const QList<atools::geo::LineString>& getAlternativeRoutes() const
+  {
+    return alternativeRoutes;
+  }
+
+  int getSelectedAlternativeRoute() const
+  {
+    return alternativeRouteSelected;
+  }
+
   /* Delete the current aircraft track. Will not stop collecting new track points */
   void deleteAircraftTrack();
 
@@ -228,6 +246,9 @@ public:
 
   const QVector<atools::fs::sc::SimConnectAircraft>& getAiAircraft() const;
 
+  /* AI and multiplayer aircraft indexed by position */
+  const AiTraffic& getAiTraffic() const;
+
   MainWindow *getParentWindow() const
   {
     return mainWindow;
@@ -248,6 +269,11 @@ public:
 
   void showOverlays(bool show);
 
+  /* Render the map into a pixmap scaled by the given factor. All vector content like airports,
+   * navaids or the flight plan is painted at the higher resolution.
+   * sourceRect in widget coordinates allows to render only a part of the map. */
+  QPixmap renderMapImage(double scale, const QRect& sourceRect = QRect());
+
   /* Stores delta values depending on fast or slow update. User aircraft is only updated if
    * delta values are exceeded. */
   struct SimUpdateDelta
@@ -312,12 +338,21 @@ signals:
   void shownMapFeaturesChanged(maptypes::MapObjectTypes types);
 
 private:
+  /* Wait for the background thread and use the aircraft track loaded on startup */
+  void takeAircraftTrack();
+
+  void aiInterpolationTimeout();
+
   bool eventFilter(QObject *obj, QEvent *e) override;
   void setDetailLevel(int factor);
 
   /* Hide and prevent re-show */
   void hideTooltip();
 
+  /* Collect object ids of a tooltip search result. Returns false if the result contains objects
+   * without id or moving aircraft. */
+  static bool tooltipIds(const maptypes::MapSearchResult& result, QVector<int>& ids);
+
   void overlayStateToMenu();
   void overlayStateFromMenu();
   void connectOverlayMenus();
@@ -366,11 +401,27 @@ private:
   int routeDragPoint = -1 /* Index of changed point */,
       routeDragLeg = -1 /* index of changed leg */;
 
+  /* Alternative routes shown while selecting one after calculation */
+  QList<atools::geo::LineString> alternativeRoutes;
+  int alternativeRouteSelected = -1;
+
   /* Save last tooltip position. If invalid/null no tooltip will be shown */
   QPoint tooltipPos;
   maptypes::MapSearchResult mapSearchResultTooltip;
   MapTooltip *mapTooltip;
 
+  /* Screen cell and static layer generation of the last tooltip search. Search is skipped if both are unchanged.
+   * The generation changes with the view, route, options or database. */
+  QPoint tooltipCell;
+  quint32 tooltipSearchGeneration = 0;
+
+  /* Object ids, static layer generation and diagram state of the last tooltip HTML.
+   * HTML is reused if all are unchanged. Weather and aircraft updates force a new HTML. */
+  QVector<int> tooltipObjectIds;
+  quint32 tooltipTextGeneration = 0;
+  bool tooltipAirportDiagram = false;
+  QString tooltipText;
+
   MainWindow *mainWindow;
   MapPaintLayer *paintLayer;
   MapQuery *mapQuery;
@@ -392,6 +443,10 @@ private:
 
   AircraftTrack aircraftTrack;
 
+  /* Track is loaded in background on startup and assigned in mainWindowShown */
+  QFuture<AircraftTrack> aircraftTrackFuture;
+  bool aircraftTrackLoading = false;
+
   QHash<QString, QAction *> mapOverlays;
 
   /* Need to check if the zoom and position was changed by the map history to avoid recursion */
@@ -405,6 +460,13 @@ private:
   qint64 lastSimUpdateMs = 0;
   bool active = false;
 
+  /* Repaints the map between simulator packets to move visible AI aircraft smoothly */
+  QTimer aiInterpolationTimer;
+  static Q_DECL_CONSTEXPR int AI_INTERPOLATION_INTERVAL_MS = 16;
+
+  /* AI aircraft are not drawn above this zoom distance */
+  static Q_DECL_CONSTEXPR int MAX_AI_INTERPOLATION_DISTANCE = 500;
+
 };
 
 Q_DECLARE_TYPEINFO(MapWidget::SimUpdateDelta, Q_PRIMITIVE_TYPE);
@@ -27,6 +27,7 @@
 #include "options/optiondata.h"
 #include "common/weatherreporter.h"
 #include "connect/connectclient.h"
+#include "atools.h"
 
 #include <QPainter>
 #include <QtPrintSupport/QPrintPreviewDialog>
@@ -40,10 +41,17 @@
 #include <QTextCursor>
 #include <QTextDocumentWriter>
 #include <QThread>
+#include <QElapsedTimer>
 
 using atools::settings::Settings;
 using atools::util::HtmlBuilder;
 
+/* Maximum factor for rendering the map at printer resolution. Larger factors add no detail. */
+static const double MAX_PRINT_RENDER_SCALE = 4.;
+
+/* Maximum number of pixels in one rendered map tile to limit memory usage */
+static const double MAX_PRINT_TILE_PIXELS = 4096. * 4096.;
+
 PrintSupport::PrintSupport(MainWindow *parent, MapQuery *mapQueryParam)
   : mainWindow(parent), mapQuery(mapQueryParam)
 {
@@ -58,7 +66,6 @@ PrintSupport::PrintSupport(MainWindow *parent, MapQuery *mapQueryParam)
 PrintSupport::~PrintSupport()
 {
   delete printFlightplanDialog;
-  delete mapScreenPrintPixmap;
   delete flightPlanPrintDocument;
 }
 
@@ -66,11 +73,6 @@ void PrintSupport::printMap()
 {
   qDebug() << Q_FUNC_INFO;
 
-  mainWindow->getMapWidget()->showOverlays(false);
-  delete mapScreenPrintPixmap;
-  mapScreenPrintPixmap = new QPixmap(mainWindow->getMapWidget()->mapScreenShot());
-  mainWindow->getMapWidget()->showOverlays(true);
-
   QPrintPreviewDialog *print = buildPreviewDialog(mainWindow);
   connect(print, &QPrintPreviewDialog::paintRequested, this, &PrintSupport::paintRequestedMap);
   print->exec();
@@ -396,28 +398,60 @@ void PrintSupport::paintRequestedFlightplan(QPrinter *printer)
 
 void PrintSupport::paintRequestedMap(QPrinter *printer)
 {
-  if(mapScreenPrintPixmap != nullptr)
-  {
-    QPixmap printScreen(mapScreenPrintPixmap->scaled(printer->pageRect().size(),
-                                                     Qt::KeepAspectRatio, Qt::SmoothTransformation));
+  MapWidget *mapWidget = mainWindow->getMapWidget();
+  QSize mapSize = mapWidget->size();
+  QRect pageRect = printer->pageRect();
+
+  if(mapSize.isEmpty() || pageRect.isEmpty())
+    return;
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // Fit map into page keeping the aspect ratio
+  double printScale = std::min(static_cast<double>(pageRect.width()) / mapSize.width(),
+                               static_cast<double>(pageRect.height()) / mapSize.height());
 
-    QPainter painter;
-    painter.begin(printer);
+  // Render at printer resolution instead of scaling a screenshot
+  double renderScale = std::max(1., std::min(printScale, MAX_PRINT_RENDER_SCALE));
 
-    qDebug() << "font.pointSize" << painter.font().pointSize()
-             << "page" << printer->pageRect() << "paper" << printer->paperRect()
-             << "screen" << mapScreenPrintPixmap->rect() << "printScreen" << printScreen.rect();
+  // Render in horizontal bands to limit the size of the offscreen pixmaps
+  int tileHeight = static_cast<int>(MAX_PRINT_TILE_PIXELS / (mapSize.width() * renderScale * renderScale));
+  tileHeight = std::max(1, std::min(tileHeight, mapSize.height()));
 
-    // Center image
-    int x = (printer->pageRect().width() - printScreen.width()) / 2;
-    int y = (printer->pageRect().height() - printScreen.height()) / 2;
+  // Center image
+  double x = (pageRect.width() - mapSize.width() * printScale) / 2.;
+  double y = (pageRect.height() - mapSize.height() * printScale) / 2.;
+  int left = atools::roundToInt(x);
+  int right = atools::roundToInt(x + mapSize.width() * printScale);
 
-    painter.drawPixmap(QPoint(x, y), printScreen);
+  QPainter painter;
+  painter.begin(printer);
+  painter.setRenderHint(QPainter::SmoothPixmapTransform);
+
+  qDebug() << "font.pointSize" << painter.font().pointSize()
+           << "page" << printer->pageRect() << "paper" << printer->paperRect()
+           << "map" << mapSize << "printScale" << printScale << "renderScale" << renderScale
+           << "tileHeight" << tileHeight;
 
-    drawWatermark(QPoint(printer->pageRect().left(), printer->pageRect().height()), &painter);
+  mapWidget->showOverlays(false);
+  for(int tileY = 0; tileY < mapSize.height(); tileY += tileHeight)
+  {
+    QRect source(0, tileY, mapSize.width(), std::min(tileHeight, mapSize.height() - tileY));
+    QPixmap tile = mapWidget->renderMapImage(renderScale, source);
 
-    painter.end();
+    // Round top and bottom of each tile separately to avoid gaps
+    int top = atools::roundToInt(y + source.top() * printScale);
+    int bottom = atools::roundToInt(y + (source.bottom() + 1) * printScale);
+    painter.drawPixmap(QRect(left, top, right - left, bottom - top), tile);
   }
+  mapWidget->showOverlays(true);
+
+  drawWatermark(QPoint(printer->pageRect().left(), printer->pageRect().height()), &painter);
+
+  painter.end();
+
+  qDebug() << Q_FUNC_INFO << "map printed in" << timer.elapsed() << "ms";
 }
 
 void PrintSupport::saveState()
@@ -80,7 +80,6 @@ private:
   MapQuery *mapQuery = nullptr;
 
   QTextDocument *flightPlanPrintDocument = nullptr;
-  QPixmap *mapScreenPrintPixmap = nullptr;
 
 };
 
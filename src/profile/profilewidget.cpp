@@ -30,6 +30,7 @@
 #include "options/optiondata.h"
 
 #include <QPainter>
+#include <QPixmap>
 #include <QTimer>
 #include <QRubberBand>
 #include <QMouseEvent>
@@ -207,6 +208,9 @@ void ProfileWidget::updateScreenCoords()
 {
   MapWidget *mapWidget = mainWindow->getMapWidget();
 
+  // Scales or route have changed - repaint the background on next paint event
+  backgroundValid = false;
+
   // Widget drawing region width and height
   int w = rect().width() - X0 * 2, h = rect().height() - Y0;
 
@@ -288,12 +292,36 @@ void ProfileWidget::updateScreenCoords()
 }
 
 void ProfileWidget::paintEvent(QPaintEvent *)
+{
+  qreal pixelRatio = devicePixelRatioF();
+  QSize pixmapSize = size() * pixelRatio;
+
+  if(!backgroundValid || background.size() != pixmapSize)
+  {
+    // Terrain, scale, flight plan and labels change only with route, elevation, options or widget size
+    background = QPixmap(pixmapSize);
+    background.setDevicePixelRatio(pixelRatio);
+
+    QPainter backgroundPainter(&background);
+    backgroundPainter.setFont(font());
+    paintBackground(backgroundPainter);
+    backgroundValid = true;
+  }
+
+  QPainter painter(this);
+  painter.drawPixmap(0, 0, background);
+
+  // Aircraft and track are drawn on top for each simulator update
+  paintOverlay(painter);
+}
+
+/* Draw all static parts of the profile */
+void ProfileWidget::paintBackground(QPainter& painter)
 {
   int w = rect().width() - X0 * 2, h = rect().height() - Y0;
 
   bool darkStyle = OptionData::instance().isGuiStyleDark();
 
-  QPainter painter(this);
   painter.setRenderHint(QPainter::Antialiasing);
   painter.fillRect(rect(), darkStyle ? mapcolors::profileBackgroundDarkColor : mapcolors::profileBackgroundColor);
   painter.fillRect(X0, 0, w, h + Y0, darkStyle ? mapcolors::profileSkyDarkColor : mapcolors::profileSkyColor);
@@ -534,71 +562,90 @@ void ProfileWidget::paintEvent(QPaintEvent *)
                          todX + 8, flightplanY + 8,
                          textatt::ROUTE_BG_COLOR | textatt::BOLD, 255);
     }
+  }
 
-    // Draw user aircraft track
-    if(!aircraftTrackPoints.isEmpty() && showAircraftTrack)
-    {
-      painter.setPen(mapcolors::aircraftTrailPen(2.f));
-      painter.drawPolyline(aircraftTrackPoints);
-    }
+  if(OptionData::instance().isGuiStyleDark())
+  {
+    int dim = OptionData::instance().getGuiStyleMapDimming();
+    QColor col = QColor::fromRgb(0, 0, 0, 255 - (255 * dim / 100));
+    painter.fillRect(QRect(0, 0, width(), height()), col);
+  }
 
-    // Draw user aircraft
-    if(simData.getUserAircraft().getPosition().isValid() && showAircraft)
-    {
-      float acx = X0 + aircraftDistanceFromStart * horizontalScale;
-      float acy = Y0 + (h - simData.getUserAircraft().getPosition().getAltitude() * verticalScale);
+}
 
-      // Draw aircraft symbol
-      painter.translate(acx, acy);
-      painter.rotate(90);
-      symPainter.drawAircraftSymbol(&painter, 0, 0, 16, simData.getUserAircraft().isOnGround());
-      painter.resetTransform();
+/* Draw user aircraft and track on top of the cached background */
+void ProfileWidget::paintOverlay(QPainter& painter)
+{
+  if(!widgetVisible || legList.elevationLegs.isEmpty() || legList.routeApprMapObjects.isEmpty() ||
+     routeController->isFlightplanEmpty())
+    return;
 
-      // Draw aircraft label
-      font.setPointSizeF(defaultFontSize);
-      painter.setFont(font);
+  int w = rect().width() - X0 * 2, h = rect().height() - Y0;
 
-      int vspeed = atools::roundToInt(simData.getUserAircraft().getVerticalSpeedFeetPerMin());
-      QString upDown;
-      if(vspeed > 100.f)
-        upDown = tr(" ▲");
-      else if(vspeed < -100.f)
-        upDown = tr(" ▼");
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.setBackgroundMode(Qt::TransparentMode);
 
-      QStringList texts;
-      texts.append(Unit::altFeet(simData.getUserAircraft().getPosition().getAltitude()));
+  QFont font = painter.font();
+  float defaultFontSize = static_cast<float>(font.pointSizeF());
+  font.setBold(true);
 
-      if(vspeed > 10.f || vspeed < -10.f)
-        texts.append(Unit::speedVertFpm(vspeed) + upDown);
+  SymbolPainter symPainter;
 
-      // texts.append(Unit::distNm(aircraftDistanceFromStart) + tr(" ► ") +
-      // Unit::distNm(aircraftDistanceToDest));
+  // Draw user aircraft track
+  if(!aircraftTrackPoints.isEmpty() && showAircraftTrack)
+  {
+    painter.setPen(mapcolors::aircraftTrailPen(2.f));
+    painter.drawPolyline(aircraftTrackPoints);
+  }
 
-      textatt::TextAttributes att = textatt::BOLD;
-      float textx = acx, texty = acy + 20.f;
+  // Draw user aircraft
+  if(simData.getUserAircraft().getPosition().isValid() && showAircraft)
+  {
+    float acx = X0 + aircraftDistanceFromStart * horizontalScale;
+    float acy = Y0 + (h - simData.getUserAircraft().getPosition().getAltitude() * verticalScale);
 
-      QRect rect = symPainter.textBoxSize(&painter, texts, att);
-      if(textx + rect.right() > X0 + w)
-        // Move text to the left when approaching the right corner
-        att |= textatt::RIGHT;
+    // Draw aircraft symbol
+    painter.translate(acx, acy);
+    painter.rotate(90);
+    symPainter.drawAircraftSymbol(&painter, 0, 0, 16, simData.getUserAircraft().isOnGround());
+    painter.resetTransform();
 
-      att |= textatt::ROUTE_BG_COLOR;
+    // Draw aircraft label
+    font.setPointSizeF(defaultFontSize);
+    painter.setFont(font);
 
-      if(texty + rect.bottom() > Y0 + h)
-        // Move text down when approaching top boundary
-        texty -= rect.bottom() + 20.f;
+    int vspeed = atools::roundToInt(simData.getUserAircraft().getVerticalSpeedFeetPerMin());
+    QString upDown;
+    if(vspeed > 100.f)
+      upDown = tr(" ▲");
+    else if(vspeed < -100.f)
+      upDown = tr(" ▼");
 
-      symPainter.textBoxF(&painter, texts, QPen(Qt::black), textx, texty, att, 255);
-    }
-  }
+    QStringList texts;
+    texts.append(Unit::altFeet(simData.getUserAircraft().getPosition().getAltitude()));
 
-  if(OptionData::instance().isGuiStyleDark())
-  {
-    int dim = OptionData::instance().getGuiStyleMapDimming();
-    QColor col = QColor::fromRgb(0, 0, 0, 255 - (255 * dim / 100));
-    painter.fillRect(QRect(0, 0, width(), height()), col);
-  }
+    if(vspeed > 10.f || vspeed < -10.f)
+      texts.append(Unit::speedVertFpm(vspeed) + upDown);
+
+    // texts.append(Unit::distNm(aircraftDistanceFromStart) + tr(" ► ") +
+    // Unit::distNm(aircraftDistanceToDest));
 
+    textatt::TextAttributes att = textatt::BOLD;
+    float textx = acx, texty = acy + 20.f;
+
+    QRect rect = symPainter.textBoxSize(&painter, texts, att);
+    if(textx + rect.right() > X0 + w)
+      // Move text to the left when approaching the right corner
+      att |= textatt::RIGHT;
+
+    att |= textatt::ROUTE_BG_COLOR;
+
+    if(texty + rect.bottom() > Y0 + h)
+      // Move text down when approaching top boundary
+      texty -= rect.bottom() + 20.f;
+
+    symPainter.textBoxF(&painter, texts, QPen(Qt::black), textx, texty, att, 255);
+  }
 }
 
 /* Update signal from Marble elevation model */
@@ -844,6 +891,10 @@ void ProfileWidget::hideEvent(QHideEvent *)
   widgetVisible = false;
   updateTimer->stop();
   terminateThread();
+
+  // Free the memory of the cached background
+  background = QPixmap();
+  backgroundValid = false;
 }
 
 void ProfileWidget::mouseMoveEvent(QMouseEvent *mouseEvent)
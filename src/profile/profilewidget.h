@@ -23,6 +23,7 @@
 
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QPixmap>
 #include <QWidget>
 
 namespace Marble {
@@ -34,6 +35,7 @@ class MainWindow;
 class RouteController;
 class QTimer;
 class QRubberBand;
+class QPainter;
 
 /*
  * Loads and displays the flight plan elevation profile. The elevation data is
@@ -117,6 +119,13 @@ private:
   };
 
   virtual void paintEvent(QPaintEvent *) override;
+
+  /* Terrain, scale, flight plan and labels. Cached in the background pixmap. */
+  void paintBackground(QPainter& painter);
+
+  /* User aircraft and track. Painted on each update. */
+  void paintOverlay(QPainter& painter);
+
   virtual void showEvent(QShowEvent *) override;
   virtual void hideEvent(QHideEvent *) override;
   virtual void mouseMoveEvent(QMouseEvent *mouseEvent) override;
@@ -178,6 +187,10 @@ private:
 
   QRubberBand *rubberBand = nullptr;
 
+  /* Cached static part of the profile. Invalidated by updateScreenCoords. */
+  QPixmap background;
+  bool backgroundValid = false;
+
   QString fixedLabelText, variableLabelText;
 
   bool widgetVisible = false, showAircraft = false, showAircraftTrack = false;
@@ -0,0 +1,336 @@
+/*****************************************************************************
+* Copyright 2015-2017 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "route/routebenchmark.h"
+
+#include "route/routefinder.h"
+#include "route/routestring.h"
+#include "route/flightplanentrybuilder.h"
+#include "mapgui/mapquery.h"
+#include "fs/pln/flightplan.h"
+#include "route/routenetworkradio.h"
+#include "route/routenetworkairway.h"
+#include "sql/sqldatabase.h"
+#include "sql/sqlquery.h"
+#include "geo/calculations.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+
+using atools::sql::SqlDatabase;
+using atools::sql::SqlQuery;
+using atools::geo::Pos;
+
+static const QString BENCHMARK_DATABASE_NAME("LNMROUTEBENCHMARKDB");
+static const QString BENCHMARK_ARGUMENT("--route-benchmark");
+static const QString STRING_BENCHMARK_ARGUMENT("--route-string-benchmark");
+
+/* Route strings are parsed twice to show the effect of the airway cache */
+static const int STRING_BENCHMARK_PASSES = 2;
+
+RouteBenchmark::RouteBenchmark(const QString& databaseFilename)
+{
+  db = new SqlDatabase(SqlDatabase::addDatabase("QSQLITE", BENCHMARK_DATABASE_NAME));
+  db->setDatabaseName(databaseFilename);
+
+  // SQLite would silently create an empty database for a missing file
+  if(QFile::exists(databaseFilename))
+  {
+    try
+    {
+      db->open();
+      databaseOpen = db->isOpen();
+    }
+    catch(const std::exception& e)
+    {
+      qWarning() << "Cannot open" << databaseFilename << e.what();
+    }
+  }
+  else
+    qWarning() << "Database" << databaseFilename << "not found";
+
+  // Networks prepare their queries on construction
+  if(databaseOpen)
+  {
+    networkRadio = new RouteNetworkRadio(db);
+    networkAirway = new RouteNetworkAirway(db);
+
+    // Always measure loading from the database and leave the user configuration untouched
+    networkRadio->setSnapshotEnabled(false);
+    networkAirway->setSnapshotEnabled(false);
+  }
+}
+
+RouteBenchmark::~RouteBenchmark()
+{
+  // Queries have to be removed before the database
+  delete networkRadio;
+  delete networkAirway;
+
+  if(databaseOpen)
+    db->close();
+  delete db;
+  SqlDatabase::removeDatabase(BENCHMARK_DATABASE_NAME);
+}
+
+bool RouteBenchmark::isRequested(int argc, char *argv[])
+{
+  for(int i = 1; i < argc; i++)
+  {
+    if(BENCHMARK_ARGUMENT == QLatin1String(argv[i]) || STRING_BENCHMARK_ARGUMENT == QLatin1String(argv[i]))
+      return true;
+  }
+  return false;
+}
+
+bool RouteBenchmark::runFromCommandLine(const QStringList& arguments, int& retval)
+{
+  int index = arguments.indexOf(BENCHMARK_ARGUMENT);
+  bool routeStrings = false;
+  if(index == -1)
+  {
+    index = arguments.indexOf(STRING_BENCHMARK_ARGUMENT);
+    routeStrings = true;
+  }
+
+  if(index == -1)
+    return false;
+
+  if(arguments.size() < index + 4)
+  {
+    if(routeStrings)
+      qWarning() << "Usage:" << STRING_BENCHMARK_ARGUMENT
+                 << "<navdata database> <route string file> <result CSV file>";
+    else
+      qWarning() << "Usage:" << BENCHMARK_ARGUMENT << "<navdata database> <airport pair file> <result CSV file>";
+    retval = 1;
+  }
+  else
+  {
+    RouteBenchmark benchmark(arguments.at(index + 1));
+    bool ok;
+    if(routeStrings)
+      ok = benchmark.runRouteStrings(arguments.at(index + 2), arguments.at(index + 3));
+    else
+      ok = benchmark.run(arguments.at(index + 2), arguments.at(index + 3));
+    retval = ok ? 0 : 1;
+  }
+  return true;
+}
+
+bool RouteBenchmark::runRouteStrings(const QString& stringFilename, const QString& resultFilename)
+{
+  if(!databaseOpen)
+    return false;
+
+  QFile stringFile(stringFilename);
+  if(!stringFile.open(QIODevice::ReadOnly | QIODevice::Text))
+  {
+    qWarning() << "Cannot open" << stringFilename << stringFile.errorString();
+    return false;
+  }
+
+  QStringList routeStrings;
+  QTextStream in(&stringFile);
+  while(!in.atEnd())
+  {
+    QString line = in.readLine().trimmed();
+    if(!line.isEmpty() && !line.startsWith("#"))
+      routeStrings.append(line);
+  }
+
+  QFile resultFile(resultFilename);
+  if(!resultFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+  {
+    qWarning() << "Cannot open" << resultFilename << resultFile.errorString();
+    return false;
+  }
+
+  QTextStream out(&resultFile);
+  out << "line,pass,items,found,time_ms,waypoints,messages" << endl;
+
+  MapQuery mapQuery(nullptr, db);
+  mapQuery.initQueries();
+  FlightplanEntryBuilder entryBuilder(&mapQuery);
+  RouteString routeString(&entryBuilder);
+
+  QElapsedTimer timer;
+  timer.start();
+  for(int pass = 1; pass <= STRING_BENCHMARK_PASSES; pass++)
+  {
+    for(int i = 0; i < routeStrings.size(); i++)
+    {
+      const QString& str = routeStrings.at(i);
+      atools::fs::pln::Flightplan flightplan;
+      float speedKts = 0.f;
+
+      QElapsedTimer parseTimer;
+      parseTimer.start();
+      bool found = routeString.createRouteFromString(str, flightplan, speedKts);
+      qint64 elapsed = parseTimer.elapsed();
+
+      out << (i + 1) << "," << pass << "," << RouteString::cleanRouteString(str).size() << ","
+          << (found ? 1 : 0) << "," << elapsed << "," << flightplan.getEntries().size() << ","
+          << routeString.getMessages().size() << endl;
+    }
+  }
+  mapQuery.deInitQueries();
+
+  qInfo() << "Parsed" << routeStrings.size() << "route strings" << STRING_BENCHMARK_PASSES << "times in"
+          << timer.elapsed() << "ms" << "peak memory" << peakMemoryKb() << "kB";
+  return true;
+}
+
+bool RouteBenchmark::run(const QString& pairFilename, const QString& resultFilename)
+{
+  if(!databaseOpen)
+    return false;
+
+  QFile pairFile(pairFilename);
+  if(!pairFile.open(QIODevice::ReadOnly | QIODevice::Text))
+  {
+    qWarning() << "Cannot open" << pairFilename << pairFile.errorString();
+    return false;
+  }
+
+  QFile resultFile(resultFilename);
+  if(!resultFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+  {
+    qWarning() << "Cannot open" << resultFilename << resultFile.errorString();
+    return false;
+  }
+
+  QTextStream out(&resultFile);
+  out << "departure,destination,mode,found,time_ms,nodes_expanded,searches,max_open_nodes,queries,"
+         "distance_nm,direct_distance_nm,waypoints" << endl;
+
+  // Load networks first to separate load time from calculation time
+  QElapsedTimer timer;
+  timer.start();
+  networkAirway->setMode(nw::ROUTE_JET | nw::ROUTE_VICTOR);
+  networkAirway->loadNetwork();
+  qInfo() << "Airway network" << networkAirway->getNumberOfNodesCache() << "nodes"
+          << networkAirway->getNumberOfEdgesCache() << "edges loaded in" << timer.restart() << "ms";
+
+  networkRadio->setMode(nw::ROUTE_RADIONAV);
+  networkRadio->loadNetwork();
+  qInfo() << "Radio network" << networkRadio->getNumberOfNodesCache() << "nodes"
+          << networkRadio->getNumberOfEdgesCache() << "edges loaded in" << timer.restart() << "ms";
+
+  int numPairs = 0;
+  QTextStream in(&pairFile);
+  while(!in.atEnd())
+  {
+    QString line = in.readLine().trimmed();
+    if(line.isEmpty() || line.startsWith("#"))
+      continue;
+
+    QStringList idents = line.simplified().split(" ");
+    if(idents.size() < 2)
+    {
+      qWarning() << "Invalid line" << line;
+      continue;
+    }
+
+    QString departure = idents.at(0).toUpper(), destination = idents.at(1).toUpper();
+    calculate(departure, destination, networkAirway, nw::ROUTE_JET, "jet", out);
+    calculate(departure, destination, networkAirway, nw::ROUTE_VICTOR, "victor", out);
+    calculate(departure, destination, networkRadio, nw::ROUTE_RADIONAV, "radionav", out);
+    numPairs++;
+  }
+
+  qInfo() << "Calculated" << numPairs << "airport pairs in" << timer.elapsed() << "ms"
+          << "peak memory" << peakMemoryKb() << "kB";
+  return true;
+}
+
+void RouteBenchmark::calculate(const QString& departure, const QString& destination, RouteNetwork *network,
+                               nw::Modes mode, const QString& modeName, QTextStream& out)
+{
+  Pos from = airportPos(departure), to = airportPos(destination);
+  if(!from.isValid() || !to.isValid())
+  {
+    qWarning() << "Airport not found" << departure << destination;
+    return;
+  }
+
+  // Jet and Victor share the airway network - remove the endpoints of the last run so that each mode
+  // pays for adding departure and destination
+  network->removeDepartureAndDestinationNodes();
+  network->setMode(mode);
+  network->resetNumQueries();
+
+  int altitude = 0;
+  if(mode == nw::ROUTE_JET)
+    altitude = ALTITUDE_JET;
+  else if(mode == nw::ROUTE_VICTOR)
+    altitude = ALTITUDE_VICTOR;
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // Calculate and extract like RouteController::calculateRouteInternal
+  RouteFinder routeFinder(network);
+  QVector<rf::RouteEntry> route;
+  float distanceMeter = 0.f;
+  bool found = routeFinder.calculateRoute(from, to, altitude);
+  if(found)
+    routeFinder.extractRoute(route, distanceMeter);
+
+  qint64 elapsed = timer.elapsed();
+
+  out << departure << "," << destination << "," << modeName << "," << (found ? 1 : 0) << ","
+      << elapsed << "," << routeFinder.getNumNodesExpanded() << "," << routeFinder.getNumSearches() << ","
+      << routeFinder.getMaxOpenNodes() << "," << network->getNumQueries() << ","
+      << QString::number(atools::geo::meterToNm(distanceMeter), 'f', 1) << ","
+      << QString::number(atools::geo::meterToNm(from.distanceMeterTo(to)), 'f', 1) << ","
+      << route.size() << endl;
+}
+
+Pos RouteBenchmark::airportPos(const QString& ident)
+{
+  Pos pos;
+  SqlQuery query(db);
+  query.prepare("select lonx, laty from airport where ident = :ident");
+  query.bindValue(":ident", ident);
+  query.exec();
+  if(query.next())
+    pos = Pos(query.value("lonx").toFloat(), query.value("laty").toFloat());
+  query.finish();
+  return pos;
+}
+
+qint64 RouteBenchmark::peakMemoryKb()
+{
+#if defined(Q_OS_LINUX)
+  // Read high water mark of resident set size
+  QFile status("/proc/self/status");
+  if(status.open(QIODevice::ReadOnly | QIODevice::Text))
+  {
+    QTextStream in(&status);
+    QString line;
+    while(!(line = in.readLine()).isNull())
+    {
+      if(line.startsWith("VmHWM:"))
+        return line.section(' ', 1, -1, QString::SectionSkipEmpty).section(' ', 0, 0).toLongLong();
+    }
+  }
+#endif
+  return -1;
+}
@@ -0,0 +1,96 @@
+/*****************************************************************************
+* Copyright 2015-2017 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_ROUTEBENCHMARK_H
+#define LITTLENAVMAP_ROUTEBENCHMARK_H
+
+#include "route/routenetwork.h"
+
+#include <QCoreApplication>
+
+namespace atools {
+namespace sql {
+class SqlDatabase;
+}
+}
+
+class RouteNetworkRadio;
+class RouteNetworkAirway;
+class QTextStream;
+
+/*
+ * Runs the route finder on a list of airport pairs without GUI and writes timing and quality
+ * statistics into a CSV file. Used to compare changes to the route calculation.
+ *
+ * Started by command line: --route-benchmark <navdata database> <airport pair file> <result CSV file>
+ *
+ * The pair file contains one departure and destination ICAO ident per line separated by space.
+ * Empty lines and lines starting with "#" are ignored. resources/benchmark/route_pairs.txt is the
+ * reference corpus to keep results comparable.
+ * Each pair is calculated using Jet and Victor airways as well as radio navaids.
+ *
+ * Networks are always loaded from the database without snapshot files. The process peak memory is
+ * logged once at the end since it cannot be attributed to single calculations.
+ *
+ * Route string parsing is measured by: --route-string-benchmark <navdata database> <route string file> <result CSV>
+ * The file contains one route string per line. resources/benchmark/route_strings.txt is the reference corpus.
+ * All strings are parsed twice to show cold and warm cache times.
+ */
+class RouteBenchmark
+{
+  Q_DECLARE_TR_FUNCTIONS(RouteBenchmark)
+
+public:
+  RouteBenchmark(const QString& databaseFilename);
+  ~RouteBenchmark();
+
+  /* Calculate all pairs and write results. Returns false if the database or a file cannot be opened. */
+  bool run(const QString& pairFilename, const QString& resultFilename);
+
+  /* true if one of the benchmark arguments is given. Checks the raw arguments to allow a decision before
+   * any application object is created. */
+  static bool isRequested(int argc, char *argv[]);
+
+  /* Parse all route strings and write results. Returns false if the database or a file cannot be opened. */
+  bool runRouteStrings(const QString& stringFilename, const QString& resultFilename);
+
+  /* Check arguments and run benchmark if requested. Returns true if benchmark was requested and
+   * fills the return value for main. */
+  static bool runFromCommandLine(const QStringList& arguments, int& retval);
+
+private:
+  /* Calculate one route and write one line into the result file */
+  void calculate(const QString& departure, const QString& destination, RouteNetwork *network,
+                 nw::Modes mode, const QString& modeName, QTextStream& out);
+
+  /* Get airport position by ICAO ident. Returns an invalid position if not found. */
+  atools::geo::Pos airportPos(const QString& ident);
+
+  /* Peak resident memory of this process in kB or -1 if not available on this platform */
+  static qint64 peakMemoryKb();
+
+  atools::sql::SqlDatabase *db = nullptr;
+  bool databaseOpen = false;
+  RouteNetworkRadio *networkRadio = nullptr;
+  RouteNetworkAirway *networkAirway = nullptr;
+
+  /* Cruise altitude for airway routes in ft */
+  static Q_DECL_CONSTEXPR int ALTITUDE_JET = 30000;
+  static Q_DECL_CONSTEXPR int ALTITUDE_VICTOR = 10000;
+};
+
+#endif // LITTLENAVMAP_ROUTEBENCHMARK_H
@@ -52,8 +52,11 @@
 
 #include <QClipboard>
 #include <QFile>
+#include <QFileInfo>
 #include <QStandardItemModel>
 #include <QInputDialog>
+#include <QProgressDialog>
+#include <QtConcurrent/QtConcurrentRun>
 
 #include <marble/GeoDataLineString.h>
 
@@ -204,6 +207,8 @@ RouteController::RouteController(MainWindow *parentWindow, MapQuery *mapQuery, Q
 
 RouteController::~RouteController()
 {
+  startupFlightplanFuture.waitForFinished();
+
   delete entryBuilder;
   delete model;
   delete iconDelegate;
@@ -397,7 +402,10 @@ void RouteController::saveState()
                                                   ui->comboBoxRouteType,
                                                   ui->spinBoxRouteAlt});
 
-  atools::settings::Settings::instance().setValue(lnm::ROUTE_FILENAME, routeFilename);
+  // Keep the file name if the flight plan was not restored yet
+  atools::settings::Settings::instance().setValue(lnm::ROUTE_FILENAME,
+                                                  startupFlightplanLoading ?
+                                                  startupFlightplanFilename : routeFilename);
 }
 
 void RouteController::updateTableHeaders()
@@ -427,15 +435,10 @@ void RouteController::restoreState()
     {
       if(QFile::exists(newRouteFilename))
       {
-        if(!loadFlightplan(newRouteFilename))
-        {
-          // Cannot be loaded - clear current filename
-          routeFilename.clear();
-          fileDeparture.clear();
-          fileDestination.clear();
-          fileIfrVfr = VFR;
-          route.clear();
-        }
+        // Read the file while the main window is set up - route is built in restoreFlightplan
+        startupFlightplanFilename = newRouteFilename;
+        startupFlightplanFuture = QtConcurrent::run(&RouteController::loadFlightplanThread, newRouteFilename);
+        startupFlightplanLoading = true;
       }
       else
       {
@@ -449,6 +452,67 @@ void RouteController::restoreState()
   }
 }
 
+RouteController::FlightplanLoadResult RouteController::loadFlightplanThread(QString filename)
+{
+  FlightplanLoadResult result;
+  try
+  {
+    // Will throw an exception if something goes wrong
+    result.flightplan.load(filename);
+  }
+  catch(...)
+  {
+    // Pass exception to the GUI thread
+    result.exception = std::current_exception();
+  }
+  return result;
+}
+
+void RouteController::restoreFlightplan()
+{
+  if(!startupFlightplanLoading)
+    return;
+
+  startupFlightplanLoading = false;
+
+  qDebug() << "restoreFlightplan" << startupFlightplanFilename;
+  if(!loadFlightplanResult(startupFlightplanFuture.result(), startupFlightplanFilename))
+  {
+    // Cannot be loaded - clear current filename
+    routeFilename.clear();
+    fileDeparture.clear();
+    fileDestination.clear();
+    fileIfrVfr = VFR;
+    route.clear();
+  }
+}
+
+bool RouteController::loadFlightplanResult(const FlightplanLoadResult& result, const QString& filename)
+{
+  try
+  {
+    if(result.exception)
+      std::rethrow_exception(result.exception);
+
+    Flightplan flightplan(result.flightplan);
+    // Convert altitude to local unit
+    flightplan.setCruisingAltitude(atools::roundToInt(Unit::altFeetF(flightplan.getCruisingAltitude())));
+
+    loadFlightplan(flightplan, filename, false /*quiet*/, false /*changed*/, 0.f);
+  }
+  catch(atools::Exception& e)
+  {
+    atools::gui::ErrorHandler(mainWindow).handleException(e);
+    return false;
+  }
+  catch(...)
+  {
+    atools::gui::ErrorHandler(mainWindow).handleUnknownException();
+    return false;
+  }
+  return true;
+}
+
 float RouteController::getSpeedKts() const
 {
   return Unit::rev(
@@ -527,29 +591,8 @@ void RouteController::loadFlightplan(const atools::fs::pln::Flightplan& flightpl
 
 bool RouteController::loadFlightplan(const QString& filename)
 {
-  Flightplan newFlightplan;
-  try
-  {
-    qDebug() << "loadFlightplan" << filename;
-    // Will throw an exception if something goes wrong
-    newFlightplan.load(filename);
-    // Convert altitude to local unit
-    newFlightplan.setCruisingAltitude(
-      atools::roundToInt(Unit::altFeetF(newFlightplan.getCruisingAltitude())));
-
-    loadFlightplan(newFlightplan, filename, false /*quiet*/, false /*changed*/, 0.f);
-  }
-  catch(atools::Exception& e)
-  {
-    atools::gui::ErrorHandler(mainWindow).handleException(e);
-    return false;
-  }
-  catch(...)
-  {
-    atools::gui::ErrorHandler(mainWindow).handleUnknownException();
-    return false;
-  }
-  return true;
+  // Read in the GUI thread and use the same error handling as for the startup file
+  return loadFlightplanResult(loadFlightplanThread(filename), filename);
 }
 
 bool RouteController::appendFlightplan(const QString& filename)
@@ -775,11 +818,115 @@ void RouteController::calculateSetAlt()
     mainWindow->setStatusMessage(tr("No route found."));
 }
 
+void RouteController::calculateAlternatives()
+{
+  qDebug() << "calculateAlternatives";
+
+  bool canceled = false, found = false;
+  if(route.getFlightplan().getRouteType() == atools::fs::pln::VOR)
+  {
+    // Keep a radionav plan radionav
+    routeNetworkRadio->setMode(nw::ROUTE_RADIONAV);
+    RouteFinder routeFinder(routeNetworkRadio);
+
+    found = calculateRouteInternal(&routeFinder, atools::fs::pln::VOR, tr("Alternative Flight Plan Calculation"),
+                                   false /* fetch airways */, false /* Use altitude */, NUM_ALTERNATIVE_ROUTES,
+                                   &canceled);
+  }
+  else
+  {
+    routeNetworkAirway->setMode(nw::ROUTE_VICTOR | nw::ROUTE_JET);
+    RouteFinder routeFinder(routeNetworkAirway);
+
+    // Just decide by given altiude if this is a high or low plan
+    atools::fs::pln::RouteType type;
+    if(route.getFlightplan().getCruisingAltitude() > Unit::altFeetF(20000))
+      type = atools::fs::pln::HIGH_ALTITUDE;
+    else
+      type = atools::fs::pln::LOW_ALTITUDE;
+
+    found = calculateRouteInternal(&routeFinder, type, tr("Alternative Flight Plan Calculation"),
+                                   true /* fetch airways */, true /* Use altitude */, NUM_ALTERNATIVE_ROUTES,
+                                   &canceled);
+  }
+
+  if(found)
+    mainWindow->setStatusMessage(tr("Calculated alternative flight plan for given altitude."));
+  else if(canceled)
+    mainWindow->setStatusMessage(tr("Flight plan calculation canceled."));
+  else
+    mainWindow->setStatusMessage(tr("No route found."));
+}
+
+int RouteController::selectAlternativeRoute(const QVector<rf::RouteResult>& routes)
+{
+  if(routes.size() == 1)
+    return 0;
+
+  QStringList items;
+  QList<atools::geo::LineString> lines;
+  for(int i = 0; i < routes.size(); i++)
+  {
+    const rf::RouteResult& result = routes.at(i);
+    items.append(tr("%1. %2, %3 waypoints, costs +%L4 %").
+                 arg(i + 1).
+                 arg(Unit::distMeter(result.distanceMeter)).
+                 arg(result.entries.size()).
+                 arg((result.costs / routes.first().costs - 1.f) * 100.f, 0, 'f', 1));
+    lines.append(result.line);
+  }
+
+  // Show all routes on the map and highlight the one currently selected in the dialog
+  MapWidget *mapWidget = mainWindow->getMapWidget();
+  mapWidget->setAlternativeRoutes(lines, 0);
+
+  QInputDialog dialog(mainWindow);
+  dialog.setWindowTitle(QApplication::applicationName());
+  dialog.setLabelText(tr("Select a flight plan:"));
+  dialog.setComboBoxItems(items);
+  dialog.setComboBoxEditable(false);
+  connect(&dialog, &QInputDialog::textValueChanged, [mapWidget, lines, items](const QString& text)
+  {
+    mapWidget->setAlternativeRoutes(lines, items.indexOf(text));
+  });
+
+  int index = dialog.exec() == QDialog::Accepted ? items.indexOf(dialog.textValue()) : -1;
+  mapWidget->clearAlternativeRoutes();
+  return index;
+}
+
+bool RouteController::updateWindGrid(int altitudeFt)
+{
+  QString filename = atools::settings::Settings::instance().valueStr(lnm::ROUTE_WIND_FILE);
+  if(filename.isEmpty())
+  {
+    windGrid.clear();
+    windGridFilename.clear();
+    return false;
+  }
+
+  QFileInfo fileinfo(filename);
+  if(filename != windGridFilename || altitudeFt != windGridAltitude ||
+     fileinfo.lastModified() != windGridLastModified)
+  {
+    windGridFilename = filename;
+    windGridAltitude = altitudeFt;
+    windGridLastModified = fileinfo.lastModified();
+
+    if(!windGrid.load(filename, altitudeFt))
+      windGrid.clear();
+  }
+  return !windGrid.isEmpty();
+}
+
 /* Calculate a flight plan to all types */
 bool RouteController::calculateRouteInternal(RouteFinder *routeFinder, atools::fs::pln::RouteType type,
                                              const QString& commandName, bool fetchAirways,
-                                             bool useSetAltitude)
+                                             bool useSetAltitude, int numAlternatives, bool *canceled)
 {
+  if(canceled != nullptr)
+    *canceled = false;
+
   // Create wait cursor if calculation takes too long
   QGuiApplication::setOverrideCursor(Qt::WaitCursor);
 
@@ -795,18 +942,75 @@ bool RouteController::calculateRouteInternal(RouteFinder *routeFinder, atools::f
   routeFinder->setPreferVorToAirway(OptionData::instance().getFlags() & opts::ROUTE_PREFER_VOR);
   routeFinder->setPreferNdbToAirway(OptionData::instance().getFlags() & opts::ROUTE_PREFER_NDB);
 
+  // Minimize flight time instead of distance if a wind file is configured
+  if(updateWindGrid(cruiseFt))
+    routeFinder->setWinds(&windGrid,
+                          atools::settings::Settings::instance().valueFloat(lnm::ROUTE_WIND_TRUE_AIRSPEED,
+                                                                            DEFAULT_WIND_TRUE_AIRSPEED));
+
   Pos departurePos = flightplan.getEntries().first().getPosition();
   Pos destinationPos = flightplan.getEntries().last().getPosition();
-  bool found = routeFinder->calculateRoute(departurePos, destinationPos, altitude);
+  bool found = false, selectionCanceled = false;
+  float distance = 0.f;
+  QVector<rf::RouteEntry> calculatedRoute;
+
+  if(numAlternatives > 1)
+  {
+    // Calculate several routes in one search and let the user select one
+    // Each spur search is a full A* run - show progress and allow to cancel
+    QGuiApplication::restoreOverrideCursor();
+    QProgressDialog progress(tr("Calculating alternative flight plans ..."), tr("&Cancel"), 0, 0, mainWindow);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
+    routeFinder->setProgressCallback([&progress](int step, int total) -> bool
+    {
+      progress.setMaximum(total);
+      progress.setValue(std::min(step, total));
+      return !progress.wasCanceled();
+    });
+
+    QVector<rf::RouteResult> routes;
+    found = routeFinder->calculateRoutes(departurePos, destinationPos, altitude, numAlternatives, routes);
+    progress.reset();
+    routeFinder->setProgressCallback(nullptr);
+    QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+
+    if(routeFinder->isCanceled())
+      selectionCanceled = true;
+    else if(found)
+    {
+      QGuiApplication::restoreOverrideCursor();
+      int index = selectAlternativeRoute(routes);
+      QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+
+      if(index >= 0)
+      {
+        calculatedRoute = routes.at(index).entries;
+        distance = routes.at(index).distanceMeter;
+      }
+      else
+        selectionCanceled = true;
+    }
+  }
+  else
+  {
+    found = routeFinder->calculateRoute(departurePos, destinationPos, altitude);
+    if(found)
+      // Fetch waypoints
+      routeFinder->extractRoute(calculatedRoute, distance);
+  }
+
+  if(selectionCanceled)
+  {
+    QGuiApplication::restoreOverrideCursor();
+    if(canceled != nullptr)
+      *canceled = true;
+    return false;
+  }
 
   if(found)
   {
     // A route was found
-    float distance = 0.f;
-    QVector<rf::RouteEntry> calculatedRoute;
-
-    // Fetch waypoints
-    routeFinder->extractRoute(calculatedRoute, distance);
 
     // Compare to direct connection and check if route is too long
     float directDistance = departurePos.distanceMeterTo(destinationPos);
@@ -1795,7 +1999,8 @@ void RouteController::routeSetDestination(maptypes::MapAirport airport)
 void RouteController::routeAttachApproach(const maptypes::MapApproachLegs& legs)
 {
   // Calculate insertion point
-  const maptypes::MapSearchResult& navaids = legs.at(0).navaids;
+  maptypes::MapSearchResult navaids;
+  legs.at(0).navaids.toSearchResult(navaids);
   const Pos& pos = legs.at(0).line.getPos1();
 
   FlightplanEntry entry;
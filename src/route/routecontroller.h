@@ -20,9 +20,15 @@
 
 #include "route/routecommand.h"
 #include "route/routemapobjectlist.h"
+#include "route/routegeometry.h"
+#include "route/windgrid.h"
 #include "common/maptypes.h"
 
 #include <QObject>
+#include <QFuture>
+#include <QDateTime>
+
+#include <exception>
 
 namespace atools {
 namespace gui {
@@ -50,6 +56,10 @@ class RouteNetwork;
 class RouteFinder;
 class FlightplanEntryBuilder;
 
+namespace rf {
+struct RouteResult;
+}
+
 /*
  * All flight plan related tasks like saving, loading, modification, calculation and table
  * view display are managed in this class.
@@ -91,6 +101,10 @@ public:
   void saveState();
   void restoreState();
 
+  /* Takes the flight plan that was read in background by restoreState and builds the route.
+   * Called once the main window is shown. Emits routeChanged. */
+  void restoreFlightplan();
+
   /* Get the route only */
   const RouteMapObjectList& getRouteMapObjects() const
   {
@@ -103,6 +117,12 @@ public:
     return routeAppr;
   }
 
+  /* Cached leg geometry and screen coordinates of the route part shared by map painter and screen index */
+  RouteGeometry& getRouteGeometry()
+  {
+    return routeGeometry;
+  }
+
   float getSpeedKts() const;
 
   /* Get a copy of all route map objects (legs) that are selected in the flight plan table view */
@@ -200,6 +220,10 @@ public:
    *  the spin box as minimum altitude */
   void calculateSetAlt();
 
+  /* Calculate several alternative flight plans in one search and let the user select one.
+   * Uses radio navaids if the current plan is radionav, otherwise low and high altitude airways. */
+  void calculateAlternatives();
+
   /* Reverse order of all waypoints, swap departure and destination and automatically
    * select a new start position (best runway) */
   void reverseRoute();
@@ -259,6 +283,20 @@ signals:
   void preRouteCalc();
 
 private:
+  /* Result of reading the last flight plan file on startup */
+  struct FlightplanLoadResult
+  {
+    atools::fs::pln::Flightplan flightplan;
+    std::exception_ptr exception; /* Exception thrown while reading */
+  };
+
+  /* Reads the flight plan file. Runs in a background thread and does not access the database. */
+  static FlightplanLoadResult loadFlightplanThread(QString filename);
+
+  /* Converts and loads a read flight plan or shows the error passed from reading.
+   * Returns false if reading or loading failed. */
+  bool loadFlightplanResult(const FlightplanLoadResult& result, const QString& filename);
+
   friend class RouteCommand;
 
   /* Move selected rows */
@@ -317,9 +355,20 @@ private:
   int adjustAltitude(const atools::geo::Pos& departurePos, const atools::geo::Pos& destinationPos,
                      const atools::fs::pln::Flightplan& flightplan, int minAltitude);
 
+  /* Load or update winds for the given altitude. Returns true if winds are available. */
+  bool updateWindGrid(int altitudeFt);
+
+  /* Calculate and apply a flight plan. If numAlternatives is larger than one several routes are calculated
+   * with a progress dialog and the user can select one. canceled is set to true if the user canceled the
+   * calculation or the selection. */
   bool calculateRouteInternal(RouteFinder *routeFinder, atools::fs::pln::RouteType type,
                               const QString& commandName,
-                              bool fetchAirways, bool useSetAltitude);
+                              bool fetchAirways, bool useSetAltitude, int numAlternatives = 1,
+                              bool *canceled = nullptr);
+
+  /* Show a list of calculated routes and highlight the selected one on the map.
+   * Returns the selected index or -1 if canceled. */
+  int selectAlternativeRoute(const QVector<rf::RouteResult>& routes);
 
   void updateFlightplanEntryAirway(int airwayId, atools::fs::pln::FlightplanEntry& entry, int& minAltitude);
 
@@ -361,6 +410,12 @@ private:
 
   static Q_DECL_CONSTEXPR int ROUTE_UNDO_LIMIT = 50;
 
+  /* Number of routes for calculateAlternatives */
+  static Q_DECL_CONSTEXPR int NUM_ALTERNATIVE_ROUTES = 5;
+
+  /* True airspeed in knots for wind based calculation if not set in settings */
+  static Q_DECL_CONSTEXPR float DEFAULT_WIND_TRUE_AIRSPEED = 450.f;
+
   atools::gui::ItemViewZoomHandler *zoomHandler = nullptr;
 
   /* Need a workaround since QUndoStack does not report current indices and clean state correctly */
@@ -374,11 +429,25 @@ private:
   /* Network cache for flight plan calculation */
   RouteNetwork *routeNetworkRadio = nullptr, *routeNetworkAirway = nullptr;
 
+  /* Winds at cruise altitude for time based flight plan calculation. Loaded from the file
+   * in settings key lnm::ROUTE_WIND_FILE and reloaded if file or altitude change. */
+  WindGrid windGrid;
+  QString windGridFilename;
+  QDateTime windGridLastModified;
+  int windGridAltitude = -1;
+
   /* Flightplan and route objects */
   RouteMapObjectList route, /* real route containing all segments */
                      routeAppr; /* Route truncated at overlap with appoach and all
                                  *  approach, transition and missed segments added */
 
+  RouteGeometry routeGeometry;
+
+  /* Flight plan file read in background on startup */
+  QFuture<FlightplanLoadResult> startupFlightplanFuture;
+  QString startupFlightplanFilename;
+  bool startupFlightplanLoading = false;
+
   /* Current filename of empty if no route - also remember start and dest to avoid accidental overwriting */
   QString routeFilename, fileDeparture, fileDestination;
   atools::fs::pln::FlightplanType fileIfrVfr;
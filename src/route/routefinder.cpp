@@ -16,9 +16,12 @@
 *****************************************************************************/
 
 #include "route/routefinder.h"
+#include "route/windgrid.h"
 #include "geo/calculations.h"
 #include "atools.h"
 
+#include <QElapsedTimer>
+
 using nw::Node;
 using nw::Edge;
 using atools::geo::Pos;
@@ -41,20 +44,161 @@ RouteFinder::~RouteFinder()
 
 }
 
+void RouteFinder::setWinds(const WindGrid *grid, float trueAirspeedKts)
+{
+  if(grid != nullptr && !grid->isEmpty() && trueAirspeedKts > 0.f)
+  {
+    windGrid = grid;
+    trueAirspeed = trueAirspeedKts;
+    windEstimateFactor = trueAirspeed / (trueAirspeed + grid->getMaxSpeed());
+  }
+  else
+  {
+    windGrid = nullptr;
+    trueAirspeed = 0.f;
+    windEstimateFactor = 1.f;
+  }
+}
+
 bool RouteFinder::calculateRoute(const atools::geo::Pos& from, const atools::geo::Pos& to, int flownAltitude)
 {
   altitude = flownAltitude;
+  numNodesExpanded = 0;
+  numSearches = 0;
+  maxOpenNodes = 0;
+
   network->addDepartureAndDestinationNodes(from, to);
   Node startNode = network->getDepartureNode();
   Node destNode = network->getDestinationNode();
 
-  int numNodesTotal = network->getNumberOfNodesDatabase();
-
   if(startNode.edges.isEmpty())
     return false;
 
+  return search(startNode, destNode, QString());
+}
+
+bool RouteFinder::calculateRoutes(const atools::geo::Pos& from, const atools::geo::Pos& to, int flownAltitude,
+                                  int numRoutes, QVector<rf::RouteResult>& routes)
+{
+  QElapsedTimer timer;
+  timer.start();
+  canceled = false;
+
+  if(progressCallback && !progressCallback(0, numRoutes))
+  {
+    canceled = true;
+    return false;
+  }
+
+  if(!calculateRoute(from, to, flownAltitude))
+    return false;
+
+  Node destNode = network->getDestinationNode();
+
+  QVector<Path> found, candidates;
+  Path shortest;
+  extractPath(destNode.id, shortest);
+  found.append(shortest);
+
+  while(found.size() < numRoutes)
+  {
+    const Path last = found.last();
+
+    // Use each node of the last route as a spur node
+    for(int i = 0; i < last.nodeIds.size() - 1; i++)
+    {
+      // One step per found route and per spur node of the route in progress
+      if(progressCallback &&
+         !progressCallback(found.size() * last.nodeIds.size() + i, numRoutes * last.nodeIds.size()))
+      {
+        canceled = true;
+        blockedNodes.clear();
+        blockedEdges.clear();
+        return false;
+      }
+
+      blockedNodes.clear();
+      blockedEdges.clear();
+
+      // Block the next edge of all routes sharing the same root path
+      for(const Path& path : found)
+      {
+        if(path.nodeIds.size() > i + 1 &&
+           std::equal(last.nodeIds.begin(), last.nodeIds.begin() + i + 1, path.nodeIds.begin()))
+          blockedEdges.insert(edgeKey(path.nodeIds.at(i), path.nodeIds.at(i + 1)));
+      }
+
+      // Block root path nodes to avoid loops
+      for(int j = 0; j < i; j++)
+        blockedNodes.insert(last.nodeIds.at(j));
+
+      if(search(network->getNode(last.nodeIds.at(i)), destNode, last.airwayNames.at(i)))
+      {
+        Path spur;
+        extractPath(destNode.id, spur);
+
+        // Join root path and spur path which starts with the spur node
+        Path total;
+        total.nodeIds = last.nodeIds.mid(0, i);
+        total.airwayIds = last.airwayIds.mid(0, i);
+        total.airwayNames = last.airwayNames.mid(0, i);
+        total.costs = last.costs.mid(0, i);
+
+        float rootCosts = last.costs.at(i);
+        for(int j = 0; j < spur.nodeIds.size(); j++)
+        {
+          total.nodeIds.append(spur.nodeIds.at(j));
+          total.airwayIds.append(j == 0 ? last.airwayIds.at(i) : spur.airwayIds.at(j));
+          total.airwayNames.append(j == 0 ? last.airwayNames.at(i) : spur.airwayNames.at(j));
+          total.costs.append(rootCosts + spur.costs.at(j));
+        }
+
+        if(!found.contains(total) && !candidates.contains(total))
+          candidates.append(total);
+      }
+    }
+
+    if(candidates.isEmpty())
+      // No more alternatives
+      break;
+
+    // Cheapest candidate is the next route
+    auto it = std::min_element(candidates.begin(), candidates.end(), [](const Path& p1, const Path& p2) -> bool
+                               {
+                                 return p1.costs.last() < p2.costs.last();
+                               });
+    found.append(*it);
+    candidates.erase(it);
+  }
+
+  blockedNodes.clear();
+  blockedEdges.clear();
+
+  for(const Path& path : found)
+  {
+    rf::RouteResult result;
+    pathToRoute(path, result.entries, result.distanceMeter, &result.line);
+    result.costs = path.costs.last();
+    routes.append(result);
+  }
+
+  qDebug() << Q_FUNC_INFO << "found" << routes.size() << "routes with" << numSearches << "searches in"
+           << timer.elapsed() << "ms";
+
+  return true;
+}
+
+bool RouteFinder::search(const nw::Node& startNode, const nw::Node& destNode, const QString& startAirwayName)
+{
+  clearSearch();
+  numSearches++;
+
+  int numNodesTotal = network->getNumberOfNodesDatabase();
+
   openNodesHeap.push(startNode, 0.f);
   nodeCosts[startNode.id] = 0.f;
+  if(!startAirwayName.isEmpty())
+    nodeAirwayName[startNode.id] = startAirwayName;
 
   Node currentNode;
   bool destinationFound = false;
@@ -78,6 +222,8 @@ bool RouteFinder::calculateRoute(const atools::geo::Pos& from, const atools::geo
 
     // Work on successors
     expandNode(currentNode, destNode);
+    numNodesExpanded++;
+    maxOpenNodes = std::max(maxOpenNodes, static_cast<int>(openNodesHeap.size()));
   }
 
   qDebug() << "found" << destinationFound << "heap size" << openNodesHeap.size()
@@ -89,31 +235,66 @@ bool RouteFinder::calculateRoute(const atools::geo::Pos& from, const atools::geo
   return destinationFound;
 }
 
+void RouteFinder::clearSearch()
+{
+  Node node;
+  while(!openNodesHeap.isEmpty())
+    openNodesHeap.pop(node);
+
+  closedNodes.clear();
+  nodeCosts.clear();
+  nodePredecessor.clear();
+  nodeAirwayId.clear();
+  nodeAirwayName.clear();
+}
+
 void RouteFinder::extractRoute(QVector<rf::RouteEntry>& route, float& distanceMeter)
+{
+  Path path;
+  extractPath(network->getDestinationNode().id, path);
+  pathToRoute(path, route, distanceMeter);
+}
+
+void RouteFinder::extractPath(int nodeId, Path& path)
+{
+  int id = nodeId;
+  while(id != -1)
+  {
+    path.nodeIds.prepend(id);
+    path.airwayIds.prepend(nodeAirwayId.value(id, -1));
+    path.airwayNames.prepend(nodeAirwayName.value(id));
+    path.costs.prepend(nodeCosts.value(id));
+    id = nodePredecessor.value(id, -1);
+  }
+}
+
+void RouteFinder::pathToRoute(const Path& path, QVector<rf::RouteEntry>& route, float& distanceMeter,
+                              atools::geo::LineString *line)
 {
   distanceMeter = 0.f;
-  route.reserve(500);
+  route.reserve(path.nodeIds.size());
 
-  // Build route
-  nw::Node pred = network->getDestinationNode();
-  while(pred.id != -1)
+  Pos lastPos;
+  for(int i = 0; i < path.nodeIds.size(); i++)
   {
     int navId;
     nw::NodeType type;
-    network->getNavIdAndTypeForNode(pred.id, navId, type);
+    network->getNavIdAndTypeForNode(path.nodeIds.at(i), navId, type);
 
     if(type != nw::DEPARTURE && type != nw::DESTINATION)
     {
       rf::RouteEntry entry;
       entry.ref = {navId, toMapObjectType(type)};
-      entry.airwayId = nodeAirwayId.value(pred.id, -1);
-      route.prepend(entry);
+      entry.airwayId = path.airwayIds.at(i);
+      route.append(entry);
     }
 
-    nw::Node next = network->getNode(nodePredecessor.value(pred.id, -1));
-    if(next.pos.isValid())
-      distanceMeter += pred.pos.distanceMeterTo(next.pos);
-    pred = next;
+    Pos pos = network->getNode(path.nodeIds.at(i)).pos;
+    if(lastPos.isValid() && pos.isValid())
+      distanceMeter += lastPos.distanceMeterTo(pos);
+    if(line != nullptr && pos.isValid())
+      line->append(pos);
+    lastPos = pos;
   }
 }
 
@@ -136,6 +317,14 @@ void RouteFinder::expandNode(const nw::Node& currentNode, const nw::Node& destNo
       // Already has a shortest path
       continue;
 
+    if(!blockedNodes.isEmpty() && blockedNodes.contains(successor.id))
+      // Part of the root path when calculating alternatives
+      continue;
+
+    if(!blockedEdges.isEmpty() && blockedEdges.contains(edgeKey(currentNode.id, successor.id)))
+      // Already used by another alternative
+      continue;
+
     const Edge& edge = successorEdges.at(i);
 
     if(altitude > 0 && edge.minAltFt > 0 && altitude < edge.minAltFt)
@@ -245,13 +434,21 @@ float RouteFinder::calculateEdgeCost(const nw::Node& currentNode, const nw::Node
       costs *= COST_FACTOR_NDB;
   }
 
+  if(windGrid != nullptr && lengthMeter > 0)
+  {
+    // Convert distance to flight time at true airspeed using the wind at the middle of the edge
+    Pos center = currentNode.pos.interpolate(successorNode.pos, lengthMeter, 0.5f);
+    float groundSpeed = windGrid->groundSpeed(center, currentNode.pos.angleDegTo(successorNode.pos), trueAirspeed);
+    costs *= trueAirspeed / groundSpeed;
+  }
+
   return costs;
 }
 
-/* GC distance in meter as costs between nodes */
+/* GC distance in meter as costs between nodes. Reduced for winds to avoid overestimating */
 float RouteFinder::costEstimate(const nw::Node& currentNode, const nw::Node& destNode)
 {
-  return currentNode.pos.distanceMeterTo(destNode.pos);
+  return currentNode.pos.distanceMeterTo(destNode.pos) * windEstimateFactor;
 }
 
 /* Convert internal network type to MapObjectTypes for extract route */
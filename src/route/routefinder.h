@@ -22,6 +22,12 @@
 #include "util/heap.h"
 #include "route/routenetwork.h"
 #include "geo/calculations.h"
+#include "geo/linestring.h"
+
+#include <QSet>
+#include <functional>
+
+class WindGrid;
 
 namespace rf {
 /* Used when fetching the route points after calculation. Adds airway id to node */
@@ -31,6 +37,14 @@ struct RouteEntry
   int airwayId;
 };
 
+/* One of several routes returned by calculateRoutes */
+struct RouteResult
+{
+  QVector<rf::RouteEntry> entries;
+  atools::geo::LineString line; /* All positions including departure and destination */
+  float distanceMeter, costs;
+};
+
 }
 
 /*
@@ -58,6 +72,29 @@ public:
    * From and to are not included in the list */
   void extractRoute(QVector<rf::RouteEntry>& route, float& distanceMeter);
 
+  /*
+   * Calculates up to numRoutes loopless routes in order of increasing costs using Yen's algorithm.
+   * The first route is the same as returned by calculateRoute. Alternatives are found by searching
+   * from each node of the previous route with used edges blocked. The network cache is shared by all searches.
+   * @param routes resulting routes. From and to are not included in the entries.
+   * @return true if at least one route was found
+   */
+  bool calculateRoutes(const atools::geo::Pos& from, const atools::geo::Pos& to, int flownAltitude,
+                       int numRoutes, QVector<rf::RouteResult>& routes);
+
+  /* Called by calculateRoutes before each search with the current step and the total number of steps.
+   * The total can grow since it depends on the length of the found routes. Return false to cancel. */
+  void setProgressCallback(const std::function<bool(int step, int total)>& callback)
+  {
+    progressCallback = callback;
+  }
+
+  /* true if the last calculateRoutes was canceled by the progress callback */
+  bool isCanceled() const
+  {
+    return canceled;
+  }
+
   /* Prefer VORs to transition from departure to airway network */
   void setPreferVorToAirway(bool value)
   {
@@ -70,7 +107,61 @@ public:
     preferNdbToAirway = value;
   }
 
+  /* Minimize flight time instead of distance using the given winds. Edge costs are scaled by true airspeed
+   * divided by the ground speed at the middle of the edge. Set grid to null to disable. */
+  void setWinds(const WindGrid *grid, float trueAirspeedKts);
+
+  /* Statistics for the last call of calculateRoute or calculateRoutes */
+  int getNumNodesExpanded() const
+  {
+    return numNodesExpanded;
+  }
+
+  int getNumSearches() const
+  {
+    return numSearches;
+  }
+
+  /* Maximum size of the open nodes heap */
+  int getMaxOpenNodes() const
+  {
+    return maxOpenNodes;
+  }
+
 private:
+  /* Node ids of a route from departure to destination */
+  struct Path
+  {
+    QVector<int> nodeIds;
+    QVector<int> airwayIds; /* Airway leading to the node or -1 */
+    QVector<QString> airwayNames; /* Airway leading to the node or empty */
+    QVector<float> costs; /* Costs from start to node */
+
+    bool operator==(const Path& other) const
+    {
+      return nodeIds == other.nodeIds;
+    }
+
+  };
+
+  /* Run A* from start to destination. startAirwayName is the airway leading to the start node. */
+  bool search(const nw::Node& startNode, const nw::Node& destNode, const QString& startAirwayName);
+
+  /* Reset all search state */
+  void clearSearch();
+
+  /* Get path from the search start to the node by following the predecessors */
+  void extractPath(int nodeId, Path& path);
+
+  /* Convert path to route entries and get the total distance. Line gets all positions if not null. */
+  void pathToRoute(const Path& path, QVector<rf::RouteEntry>& route, float& distanceMeter,
+                   atools::geo::LineString *line = nullptr);
+
+  static quint64 edgeKey(int fromNodeId, int toNodeId)
+  {
+    return (static_cast<quint64>(static_cast<quint32>(fromNodeId)) << 32) | static_cast<quint32>(toNodeId);
+  }
+
   void expandNode(const nw::Node& node, const nw::Node& destNode);
   float calculateEdgeCost(const nw::Node& node, const nw::Node& successorNode, int lengthMeter);
   float costEstimate(const nw::Node& currentNode, const nw::Node& destNode);
@@ -110,6 +201,19 @@ private:
 
   int altitude = 0;
 
+  /* Winds for time based costs or null */
+  const WindGrid *windGrid = nullptr;
+  float trueAirspeed = 0.f;
+
+  /* Factor for the distance estimate to keep it below the costs for the strongest tailwind */
+  float windEstimateFactor = 1.f;
+
+  /* Statistics reset by calculateRoute */
+  int numNodesExpanded = 0, numSearches = 0, maxOpenNodes = 0;
+
+  std::function<bool(int step, int total)> progressCallback;
+  bool canceled = false;
+
   RouteNetwork *network;
 
   /* Heap structure storing open nodes.
@@ -129,6 +233,10 @@ private:
   QHash<int, int> nodeAirwayId;
   QHash<int, QString> nodeAirwayName;
 
+  /* Nodes and edges excluded from the search when calculating alternative routes */
+  QSet<int> blockedNodes;
+  QSet<quint64> blockedEdges;
+
   /* For RouteNetwork::getNeighbours to avoid instantiations */
   QVector<nw::Node> successorNodes;
   QVector<nw::Edge> successorEdges;
@@ -0,0 +1,259 @@
+/*****************************************************************************
+* Copyright 2015-2017 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "route/routegeometry.h"
+
+#include "route/routemapobjectlist.h"
+#include "common/coordinateconverter.h"
+#include "geo/calculations.h"
+#include "atools.h"
+
+#include <marble/ViewportParams.h>
+#include <marble/MarbleGlobal.h>
+
+#include <QLineF>
+
+using atools::geo::Pos;
+using atools::geo::LineString;
+
+/* Length of an interpolated segment in meter */
+static const float SEGMENT_LENGTH_METER = 10000.f;
+
+/* Minimum and maximum number of interpolated segments per leg */
+static const int MIN_SEGMENTS = 4;
+static const int MAX_SEGMENTS = 256;
+
+/* Approximate screen length of a simplified segment in pixel */
+static const float SEGMENT_LENGTH_PIXEL = 20.f;
+
+bool RouteGeometry::ViewKey::operator==(const RouteGeometry::ViewKey& other) const
+{
+  return centerLon == other.centerLon && centerLat == other.centerLat && radius == other.radius &&
+         projection == other.projection && width == other.width && height == other.height;
+}
+
+RouteGeometry::RouteGeometry()
+{
+
+}
+
+RouteGeometry::~RouteGeometry()
+{
+
+}
+
+void RouteGeometry::clear()
+{
+  waypoints.clear();
+  legPositions.clear();
+  legDistances.clear();
+  screenLegs.clear();
+  textPosCache.clear();
+  screenValid = false;
+}
+
+int RouteGeometry::numSegmentsForDistance(float distanceMeter)
+{
+  // Use a power of two to allow simplification by an integer stride
+  int num = MIN_SEGMENTS;
+  while(num < MAX_SEGMENTS && num * SEGMENT_LENGTH_METER < distanceMeter)
+    num *= 2;
+  return num;
+}
+
+void RouteGeometry::updateRoute(const RouteMapObjectList& routeMapObjects)
+{
+  int num = std::min(routeMapObjects.getApproachStartIndex(), routeMapObjects.size());
+
+  // Check if anything has changed
+  bool changed = num != waypoints.size();
+  for(int i = 0; i < num && !changed; i++)
+    changed = routeMapObjects.at(i).getPosition() != waypoints.at(i);
+
+  if(!changed)
+    return;
+
+  clear();
+
+  waypoints.reserve(num);
+  legPositions.resize(num);
+  legDistances.resize(num);
+
+  for(int i = 0; i < num; i++)
+  {
+    const Pos& pos = routeMapObjects.at(i).getPosition();
+    waypoints.append(pos);
+
+    if(i > 0)
+    {
+      const Pos& prev = waypoints.at(i - 1);
+      float distanceMeter = prev.distanceMeterTo(pos);
+      int numSegments = numSegmentsForDistance(distanceMeter);
+
+      LineString& leg = legPositions[i];
+      leg.reserve(numSegments + 1);
+      leg.append(prev);
+      for(int j = 1; j < numSegments; j++)
+        leg.append(prev.interpolate(pos, distanceMeter, static_cast<float>(j) / numSegments));
+      leg.append(pos);
+
+      legDistances[i] = distanceMeter;
+    }
+  }
+}
+
+void RouteGeometry::updateScreen(const CoordinateConverter& converter)
+{
+  const Marble::ViewportParams *viewport = converter.getViewport();
+
+  ViewKey key;
+  key.centerLon = viewport->centerLongitude();
+  key.centerLat = viewport->centerLatitude();
+  key.radius = viewport->radius();
+  key.projection = viewport->projection();
+  key.width = viewport->width();
+  key.height = viewport->height();
+
+  if(screenValid && key == viewKey)
+    return;
+
+  viewKey = key;
+  screenValid = true;
+  textPosCache.clear();
+  screenLegs.clear();
+  screenLegs.resize(waypoints.size());
+
+  // Collect the simplified points of all legs to project them in one call
+  QVector<Pos> positions;
+  QVector<int> legOffsets(waypoints.size() + 1, 0);
+  float pixelPerMeter = static_cast<float>(viewport->radius() / Marble::EARTH_RADIUS);
+  for(int i = 1; i < waypoints.size(); i++)
+  {
+    const LineString& leg = legPositions.at(i);
+    int numSegments = leg.size() - 1;
+
+    // Reduce the number of segments depending on the leg length on the screen
+    int needed = MIN_SEGMENTS;
+    float pixelLength = legDistances.at(i) * pixelPerMeter;
+    while(needed < numSegments && needed * SEGMENT_LENGTH_PIXEL < pixelLength)
+      needed *= 2;
+    int stride = numSegments / std::min(needed, numSegments);
+
+    legOffsets[i] = positions.size();
+    for(int j = 0; j < leg.size(); j += stride)
+      positions.append(leg.at(j));
+    legOffsets[i + 1] = positions.size();
+  }
+
+  QVector<QPoint> points;
+  QVector<bool> hidden;
+  converter.wToS(positions, points, nullptr, QSize(key.width, key.height), &hidden);
+
+  // Split lines where the projection jumps at the anti meridian in Mercator
+  bool splitAntiMeridian = key.projection == Marble::Mercator;
+  for(int i = 1; i < waypoints.size(); i++)
+  {
+    ScreenLeg& screenLeg = screenLegs[i];
+    QPolygonF polyline;
+    for(int j = legOffsets.at(i); j < legOffsets.at(i + 1); j++)
+    {
+      QPointF pt(points.at(j));
+      screenLeg.points.append(pt);
+      screenLeg.hidden.append(hidden.at(j));
+
+      bool split = hidden.at(j) ||
+                   (splitAntiMeridian && j > legOffsets.at(i) &&
+                    std::abs(positions.at(j).getLonX() - positions.at(j - 1).getLonX()) > 180.f);
+      if(split && polyline.size() > 1)
+        screenLeg.polylines.append(polyline);
+      if(split)
+        polyline.clear();
+
+      if(!hidden.at(j))
+        polyline.append(pt);
+    }
+    if(polyline.size() > 1)
+      screenLeg.polylines.append(polyline);
+  }
+}
+
+bool RouteGeometry::findTextPos(int leg, int textWidth, int textHeight, const QRect& window,
+                                int& x, int& y, float *bearing)
+{
+  if(window != textPosWindow)
+  {
+    textPosCache.clear();
+    textPosWindow = window;
+  }
+
+  quint64 key = (static_cast<quint64>(leg) << 32) | (static_cast<quint64>(textWidth & 0xffff) << 16) |
+                static_cast<quint64>(textHeight & 0xffff);
+
+  auto it = textPosCache.constFind(key);
+  if(it == textPosCache.constEnd())
+  {
+    TextPos pos;
+    pos.found = findTextPosInternal(screenLegs.at(leg), textWidth, textHeight, window, pos.x, pos.y, &pos.bearing);
+    it = textPosCache.insert(key, pos);
+  }
+
+  x = it->x;
+  y = it->y;
+  if(bearing != nullptr)
+    *bearing = it->bearing;
+  return it->found;
+}
+
+bool RouteGeometry::findTextPosInternal(const ScreenLeg& screenLeg, int textWidth, int textHeight,
+                                        const QRect& window, int& x, int& y, float *bearing) const
+{
+  int numSegments = screenLeg.points.size() - 1;
+  if(numSegments < 1)
+    return false;
+
+  int size = std::max(textWidth, textHeight);
+
+  // Points are equally spaced along the great circle which allows to use the fraction of the point index
+  auto check = [&](float fraction) -> bool
+               {
+                 float index = fraction * numSegments;
+                 int j = std::min(static_cast<int>(index), numSegments - 1);
+                 if(j < 0 || screenLeg.hidden.at(j) || screenLeg.hidden.at(j + 1))
+                   return false;
+
+                 QLineF line(screenLeg.points.at(j), screenLeg.points.at(j + 1));
+                 QPointF pt = line.pointAt(index - j);
+                 x = atools::roundToInt(pt.x());
+                 y = atools::roundToInt(pt.y());
+
+                 if(window.contains(QRect(x - size / 2, y - size / 2, size, size)))
+                 {
+                   if(bearing != nullptr)
+                     *bearing = static_cast<float>(atools::geo::normalizeCourse(-line.angle() + 270.f));
+                   return true;
+                 }
+                 return false;
+               };
+
+  // Check for 50 positions along the line starting at the center and moving outwards
+  for(float i = 0.f; i <= 0.5f; i += FIND_TEXT_POS_STEP)
+  {
+    if(check(0.5f - i) || check(0.5f + i))
+      return true;
+  }
+  return false;
+}
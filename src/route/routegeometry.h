@@ -0,0 +1,149 @@
+/*****************************************************************************
+* Copyright 2015-2017 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_ROUTEGEOMETRY_H
+#define LITTLENAVMAP_ROUTEGEOMETRY_H
+
+#include "geo/linestring.h"
+
+#include <QHash>
+#include <QPolygonF>
+#include <QRect>
+#include <QVector>
+
+class CoordinateConverter;
+class RouteMapObjectList;
+
+/*
+ * Caches the great circle geometry of the flight plan legs and their screen coordinates.
+ *
+ * Legs are interpolated once after each route change. Screen coordinates are calculated once for each
+ * view using a zoom dependent subset of the interpolated points. The result is shared by the route painter,
+ * the text placement and the map screen index.
+ *
+ * Only the route part up to the start of an approach or transition is covered.
+ * A leg index is the index of the waypoint at the end of the leg. Leg 0 is always empty.
+ */
+class RouteGeometry
+{
+public:
+  RouteGeometry();
+  ~RouteGeometry();
+
+  /* Update the interpolated legs if the route positions have changed */
+  void updateRoute(const RouteMapObjectList& routeMapObjects);
+
+  /* Update the screen coordinates if the view or the route has changed */
+  void updateScreen(const CoordinateConverter& converter);
+
+  void clear();
+
+  /* Number of waypoints covered by this geometry */
+  int size() const
+  {
+    return waypoints.size();
+  }
+
+  bool isEmpty() const
+  {
+    return waypoints.isEmpty();
+  }
+
+  /* Screen polylines for a leg. Split where points are hidden behind the globe. */
+  const QVector<QPolygonF>& getLegPolylines(int leg) const
+  {
+    return screenLegs.at(leg).polylines;
+  }
+
+  /* Simplified screen points of a leg including start and end */
+  const QPolygonF& getLegPoints(int leg) const
+  {
+    return screenLegs.at(leg).points;
+  }
+
+  /* Flags for getLegPoints indicating if a point is hidden behind the globe */
+  const QVector<bool>& getLegHidden(int leg) const
+  {
+    return screenLegs.at(leg).hidden;
+  }
+
+  /* Find text position along the screen geometry of a leg. Results are cached until the view changes.
+   *  @param x,y resulting text position
+   *  @param bearing text bearing at the returned position
+   *  @return true if a position was found inside the window
+   */
+  bool findTextPos(int leg, int textWidth, int textHeight, const QRect& window, int& x, int& y, float *bearing);
+
+private:
+  /* Defines the view for the cached screen coordinates */
+  struct ViewKey
+  {
+    double centerLon = 0., centerLat = 0.;
+    int radius = 0, projection = -1, width = 0, height = 0;
+
+    bool operator==(const ViewKey& other) const;
+
+    bool operator!=(const ViewKey& other) const
+    {
+      return !operator==(other);
+    }
+
+  };
+
+  struct ScreenLeg
+  {
+    QPolygonF points;
+    QVector<bool> hidden;
+    QVector<QPolygonF> polylines;
+  };
+
+  struct TextPos
+  {
+    bool found = false;
+    int x = 0, y = 0;
+    float bearing = 0.f;
+  };
+
+  bool findTextPosInternal(const ScreenLeg& screenLeg, int textWidth, int textHeight, const QRect& window,
+                           int& x, int& y, float *bearing) const;
+
+  /* Number of interpolated segments for a leg */
+  static int numSegmentsForDistance(float distanceMeter);
+
+  /* Waypoint positions */
+  atools::geo::LineString waypoints;
+
+  /* Interpolated points for each leg including start and end. Number of segments is a power of two. */
+  QVector<atools::geo::LineString> legPositions;
+
+  /* Distance in meter for each leg */
+  QVector<float> legDistances;
+
+  /* Screen geometry for the current view */
+  QVector<ScreenLeg> screenLegs;
+  ViewKey viewKey;
+  bool screenValid = false;
+
+  /* Text anchors for the current view and window. Key is leg, text width and text height. */
+  QHash<quint64, TextPos> textPosCache;
+  QRect textPosWindow;
+
+  /* Evaluate 50 text placement positions along line */
+  static Q_DECL_CONSTEXPR float FIND_TEXT_POS_STEP = 0.02f;
+};
+
+#endif // LITTLENAVMAP_ROUTEGEOMETRY_H
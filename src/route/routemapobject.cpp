@@ -20,7 +20,6 @@
 #include "geo/calculations.h"
 #include "fs/pln/flightplan.h"
 #include "atools.h"
-#include "route/routemapobjectlist.h"
 
 #include <QRegularExpression>
 
@@ -312,38 +311,19 @@ void RouteMapObject::updateMagvar()
     magvar = 0.f;
 }
 
-void RouteMapObject::updateInvalidMagvar(int entryIndex, const RouteMapObjectList *routeList)
+void RouteMapObject::updateInvalidMagvar(float magvarPrev, float magvarNext)
 {
   if(type == maptypes::USER || type == maptypes::INVALID)
   {
-    magvar = 0.f;
-    // Get magnetic variance from one of the next and previous waypoints if not set
-    float magvarnext = 0.f, magvarprev = 0.f;
-    for(int i = std::min(entryIndex, routeList->size() - 1); i >= 0; i--)
-    {
-      if(atools::almostNotEqual(routeList->at(i).getMagvar(), 0.f))
-      {
-        magvarnext = routeList->at(i).getMagvar();
-        break;
-      }
-    }
-
-    for(int i = std::min(entryIndex, routeList->size() - 1); i < routeList->size(); i++)
-    {
-      if(atools::almostNotEqual(routeList->at(i).getMagvar(), 0.f))
-      {
-        magvarprev = routeList->at(i).getMagvar();
-        break;
-      }
-    }
-
     // Use average of previous and next or one valid value
-    if(std::abs(magvarnext) > 0.f && std::abs(magvarprev) > 0.f)
-      magvar = (magvarnext + magvarprev) / 2.f;
-    else if(std::abs(magvarnext) > 0.f)
-      magvar = magvarnext;
-    else if(std::abs(magvarprev) > 0.f)
-      magvar = magvarprev;
+    if(std::abs(magvarPrev) > 0.f && std::abs(magvarNext) > 0.f)
+      magvar = (magvarPrev + magvarNext) / 2.f;
+    else if(std::abs(magvarPrev) > 0.f)
+      magvar = magvarPrev;
+    else if(std::abs(magvarNext) > 0.f)
+      magvar = magvarNext;
+    else
+      magvar = 0.f;
   }
 }
 
@@ -367,20 +347,32 @@ void RouteMapObject::updateDistanceAndCourse(int entryIndex, const RouteMapObjec
     predecessor = true;
     distanceTo = approachLeg.calculatedDistance;
     distanceToRhumb = approachLeg.calculatedDistance;
+    legValid = false;
   }
   else if(predRouteMapObj != nullptr)
   {
     predecessor = true;
+    const Pos& pos = getPosition();
     const Pos& prevPos = predRouteMapObj->getPosition();
-    distanceTo = meterToNm(getPosition().distanceMeterTo(prevPos));
-    distanceToRhumb = meterToNm(getPosition().distanceMeterToRhumb(prevPos));
-    courseTo = normalizeCourse(predRouteMapObj->getPosition().angleDegTo(getPosition()));
-    courseRhumbTo = normalizeCourse(predRouteMapObj->getPosition().angleDegToRhumb(getPosition()));
+
+    // Leg is unchanged - keep values
+    if(legValid && pos == legPos && prevPos == legPredPos)
+      return;
+
+    distanceTo = meterToNm(pos.distanceMeterTo(prevPos));
+    distanceToRhumb = meterToNm(pos.distanceMeterToRhumb(prevPos));
+    courseTo = normalizeCourse(prevPos.angleDegTo(pos));
+    courseRhumbTo = normalizeCourse(prevPos.angleDegToRhumb(pos));
+
+    legPos = pos;
+    legPredPos = prevPos;
+    legValid = true;
   }
   else
   {
     // No predecessor - this one is the first in the list
     predecessor = false;
+    legValid = false;
     distanceTo = 0.f;
     distanceToRhumb = 0.f;
     courseTo = 0.f;
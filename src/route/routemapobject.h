@@ -32,7 +32,6 @@ class Flightplan;
 }
 
 class MapQuery;
-class RouteMapObjectList;
 
 /*
  * A flight plan waypoint, departure or destination. Data is loaded from the database. Provides
@@ -72,6 +71,7 @@ public:
 
   /*
    * Updates distance and course to this object if the predecessor is not null. Will reset values otherwise.
+   * Calculation is skipped if the positions of this and the predecessor did not change since the last call.
    * @param predRouteMapObj
    */
   void updateDistanceAndCourse(int entryIndex, const RouteMapObject *predRouteMapObj);
@@ -79,8 +79,9 @@ public:
   /* Get magvar from all known objects */
   void updateMagvar();
 
-  /* Update for user and invalid. Needs all others updated before */
-  void updateInvalidMagvar(int entryIndex, const RouteMapObjectList *routeList);
+  /* Update for user and invalid using the nearest valid magvar of the previous and next entries.
+   * Values are 0 if there is no valid magvar. */
+  void updateInvalidMagvar(float magvarPrev, float magvarNext);
 
   /* Change user defined waypoint name */
   void updateUserName(const QString& name);
@@ -256,6 +257,10 @@ private:
         groundAltitude = 0.f,
         magvar = 0.f; /* Either taken from navaid or average across the route */
 
+  /* Positions used for the last distance and course calculation */
+  atools::geo::Pos legPos, legPredPos;
+  bool legValid = false;
+
 };
 
 #endif // LITTLENAVMAP_ROUTEMAPOBJECT_H
@@ -20,6 +20,7 @@
 #include "geo/calculations.h"
 #include "common/maptools.h"
 #include "common/unit.h"
+#include "atools.h"
 
 #include <QRegularExpression>
 
@@ -612,13 +613,33 @@ void RouteMapObjectList::updateDistancesAndCourse()
 
 void RouteMapObjectList::updateMagvar()
 {
+  int num = size();
+
   // get magvar from internal database objects
-  for(int i = 0; i < size(); i++)
-    (*this)[i].updateMagvar();
+  QVector<float> magvars(num);
+  for(int i = 0; i < num; i++)
+  {
+    RouteMapObject& obj = (*this)[i];
+    obj.updateMagvar();
+    magvars[i] = obj.getMagvar();
+  }
 
-  // Update missing magvar values using neighbour entries
-  for(int i = 0; i < size(); i++)
-    (*this)[i].updateInvalidMagvar(i, this);
+  // Get the nearest valid magvar at or after each entry in one backward pass
+  QVector<float> magvarsNext(num + 1, 0.f);
+  for(int i = num - 1; i >= 0; i--)
+    magvarsNext[i] = atools::almostNotEqual(magvars.at(i), 0.f) ? magvars.at(i) : magvarsNext.at(i + 1);
+
+  // Update missing magvar values using neighbour entries in one forward pass
+  // Calculated values are used as previous value for the following entries
+  float magvarPrev = 0.f;
+  for(int i = 0; i < num; i++)
+  {
+    RouteMapObject& obj = (*this)[i];
+    obj.updateInvalidMagvar(magvarPrev, magvarsNext.at(i));
+
+    if(atools::almostNotEqual(obj.getMagvar(), 0.f))
+      magvarPrev = obj.getMagvar();
+  }
 
   trueCourse = true;
   // Check if there is any magnetic variance on the route
@@ -24,8 +24,12 @@
 
 #include "geo/pos.h"
 #include "geo/rect.h"
+#include "settings/settings.h"
 
 #include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSaveFile>
 
 using atools::sql::SqlDatabase;
 using atools::sql::SqlQuery;
@@ -64,6 +68,14 @@ int RouteNetwork::getNumberOfNodesCache() const
   return nodeCache.size();
 }
 
+int RouteNetwork::getNumberOfEdgesCache() const
+{
+  int numEdges = 0;
+  for(const nw::Node& node : nodeCache)
+    numEdges += node.edges.size();
+  return numEdges;
+}
+
 void RouteNetwork::setMode(nw::Modes routeMode)
 {
   mode = routeMode;
@@ -75,6 +87,7 @@ void RouteNetwork::clearStartAndDestinationNodes()
   departurePos = atools::geo::EMPTY_POS;
   destinationPos = atools::geo::EMPTY_POS;
   nodeCache.clear();
+  networkLoaded = false;
   destinationNodePredecessors.clear();
   numNodesDb = -1;
   nodeIndexesCreated = false;
@@ -113,6 +126,8 @@ void RouteNetwork::addDepartureAndDestinationNodes(const atools::geo::Pos& from,
 {
   qDebug() << "adding start and  destination to network";
 
+  loadNetwork();
+
   if(departurePos == from && destinationPos == to)
     return;
 
@@ -142,6 +157,15 @@ void RouteNetwork::addDepartureAndDestinationNodes(const atools::geo::Pos& from,
   qDebug() << "adding start and  destination to network done";
 }
 
+void RouteNetwork::removeDepartureAndDestinationNodes()
+{
+  cleanDestNodeEdges();
+  nodeCache.remove(DEPARTURE_NODE_ID);
+  nodeCache.remove(DESTINATION_NODE_ID);
+  departurePos = atools::geo::EMPTY_POS;
+  destinationPos = atools::geo::EMPTY_POS;
+}
+
 nw::Node RouteNetwork::getDepartureNode() const
 {
   return nodeCache.value(DEPARTURE_NODE_ID);
@@ -212,6 +236,7 @@ nw::Node RouteNetwork::fetchNodeByNavId(int id, nw::NodeType type)
   nodeByNavIdQuery->bindValue(":id", id);
   nodeByNavIdQuery->bindValue(":type", type);
   nodeByNavIdQuery->exec();
+  numQueries++;
 
   nw::Node node;
 
@@ -225,6 +250,7 @@ nw::Node RouteNetwork::fetchNodeByNavId(int id, nw::NodeType type)
       // Not found and is an airway - look for waypoints
       nodeByNavIdQuery->bindValue(":type", nw::WAYPOINT_BOTH);
       nodeByNavIdQuery->exec();
+      numQueries++;
       if(nodeByNavIdQuery->next())
         node = fetchNode(nodeByNavIdQuery->value("node_id").toInt());
     }
@@ -251,6 +277,7 @@ void RouteNetwork::getNavIdAndTypeForNode(int nodeId, int& navId, nw::NodeType&
   {
     nodeNavIdAndTypeQuery->bindValue(":id", nodeId);
     nodeNavIdAndTypeQuery->exec();
+    numQueries++;
 
     if(nodeNavIdAndTypeQuery->next())
     {
@@ -305,6 +332,7 @@ nw::Node RouteNetwork::fetchNode(float lonx, float laty, bool loadSuccessors, in
     {
       bindCoordRect(rect, nearestNodesQuery);
       nearestNodesQuery->exec();
+      numQueries++;
       while(nearestNodesQuery->next())
       {
         int nodeId = nearestNodesQuery->value("node_id").toInt();
@@ -329,11 +357,18 @@ nw::Node RouteNetwork::fetchNode(float lonx, float laty, bool loadSuccessors, in
 /* Get the node either from cache of from the database. The node will include all edges. */
 nw::Node RouteNetwork::fetchNode(int id)
 {
+  loadNetwork();
+
   if(nodeCache.contains(id))
     return nodeCache.value(id);
 
+  if(networkLoaded)
+    // Complete network is in the cache
+    return nw::Node();
+
   nodeByIdQuery->bindValue(":id", id);
   nodeByIdQuery->exec();
+  numQueries++;
   nw::Node node;
 
   if(nodeByIdQuery->next())
@@ -347,6 +382,7 @@ nw::Node RouteNetwork::fetchNode(int id)
     // Add ingoing edges
     edgeToQuery->bindValue(":id", id);
     edgeToQuery->exec();
+    numQueries++;
 
     while(edgeToQuery->next())
     {
@@ -358,6 +394,7 @@ nw::Node RouteNetwork::fetchNode(int id)
     // Add outgoing edges
     edgeFromQuery->bindValue(":id", id);
     edgeFromQuery->exec();
+    numQueries++;
 
     while(edgeFromQuery->next())
     {
@@ -564,3 +601,250 @@ void RouteNetwork::bindCoordRect(const atools::geo::Rect& rect, atools::sql::Sql
   query->bindValue(":bottomy", rect.getSouth());
   query->bindValue(":topy", rect.getNorth());
 }
+
+void RouteNetwork::loadNetwork()
+{
+  if(networkLoaded)
+    return;
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // Snapshot is only valid for the exact database file
+  QFileInfo dbFile(db->databaseName());
+  SnapshotHeader header = {SNAPSHOT_MAGIC_NUMBER, SNAPSHOT_VERSION, dbFile.size(),
+                           dbFile.lastModified().toMSecsSinceEpoch(), 0, 0, 0, 0};
+
+  QString filename = getSnapshotFilename();
+  bool fromSnapshot = snapshotEnabled && readSnapshot(filename, header);
+  if(!fromSnapshot)
+  {
+    QVector<SnapshotNode> nodes;
+    QVector<SnapshotEdge> edges;
+    QStringList airwayNames;
+    loadNetworkDatabase(nodes, edges, airwayNames);
+    fillCache(nodes.constData(), nodes.size(), edges.constData(), edges.size(), airwayNames);
+    if(snapshotEnabled)
+      writeSnapshot(filename, header, nodes, edges, airwayNames);
+  }
+  networkLoaded = true;
+
+  qDebug() << Q_FUNC_INFO << nodeTable << "loaded" << nodeCache.size() << "nodes"
+           << (fromSnapshot ? "from snapshot" : "from database") << "in" << timer.elapsed() << "ms";
+}
+
+QString RouteNetwork::getSnapshotFilename() const
+{
+  return atools::settings::Settings::getConfigFilename(
+    "_" + QFileInfo(db->databaseName()).completeBaseName() + "_" + nodeTable + ".network");
+}
+
+/* Read all nodes and edges with two queries */
+void RouteNetwork::loadNetworkDatabase(QVector<SnapshotNode>& nodes, QVector<SnapshotEdge>& edges,
+                                       QStringList& airwayNames)
+{
+  bool hasRange = nodeExtraCols.contains("range");
+  SqlQuery nodeQuery(db);
+  nodeQuery.exec("select node_id, type, lonx, laty" + QString(hasRange ? ", range" : "") + " from " + nodeTable);
+  numQueries++;
+  while(nodeQuery.next())
+    nodes.append({nodeQuery.value(0).toInt(), nodeQuery.value(1).toInt(), hasRange ? nodeQuery.value(4).toInt() : 0,
+                  nodeQuery.value(2).toFloat(), nodeQuery.value(3).toFloat()});
+  nodeQuery.finish();
+
+  QString edgeCols = edgeExtraCols.join(",");
+  if(!edgeExtraCols.isEmpty())
+    edgeCols.prepend(", ");
+
+  SqlQuery edgeQuery(db);
+  edgeQuery.exec("select from_node_id, from_node_type, to_node_id, to_node_type" + edgeCols + " from " + edgeTable);
+  numQueries++;
+
+  // Extra columns are optional
+  SqlRecord rec = edgeQuery.record();
+  int typeIndex = rec.contains("type") ? rec.indexOf("type") : -1;
+  int minAltIndex = rec.contains("minimum_altitude") ? rec.indexOf("minimum_altitude") : -1;
+  int airwayIdIndex = rec.contains("airway_id") ? rec.indexOf("airway_id") : -1;
+  int airwayNameIndex = rec.contains("airway_name") ? rec.indexOf("airway_name") : -1;
+  int distanceIndex = rec.contains("distance") ? rec.indexOf("distance") : -1;
+
+  // Store each airway name only once
+  QHash<QString, int> airwayNameIds;
+  while(edgeQuery.next())
+  {
+    SnapshotEdge edge = {edgeQuery.value(0).toInt(), edgeQuery.value(1).toInt(),
+                         edgeQuery.value(2).toInt(), edgeQuery.value(3).toInt(),
+                         nw::AIRWAY_NONE, 0, -1, -1, 0};
+
+    if(typeIndex != -1)
+      edge.type = edgeQuery.value(typeIndex).toInt();
+    if(minAltIndex != -1)
+      edge.minAltFt = edgeQuery.value(minAltIndex).toInt();
+    if(airwayIdIndex != -1)
+      edge.airwayId = edgeQuery.value(airwayIdIndex).toInt();
+    if(distanceIndex != -1)
+      edge.lengthMeter = edgeQuery.value(distanceIndex).toInt();
+    if(airwayNameIndex != -1)
+    {
+      QString name = edgeQuery.value(airwayNameIndex).toString();
+      auto it = airwayNameIds.constFind(name);
+      if(it == airwayNameIds.constEnd())
+      {
+        it = airwayNameIds.insert(name, airwayNames.size());
+        airwayNames.append(name);
+      }
+      edge.airwayName = it.value();
+    }
+    edges.append(edge);
+  }
+  edgeQuery.finish();
+}
+
+/* Convert flat arrays into nodes with attached edges. Edges are added in both directions like in fetchNode. */
+void RouteNetwork::fillCache(const SnapshotNode *nodes, int numNodes, const SnapshotEdge *edges, int numEdges,
+                             const QStringList& airwayNames)
+{
+  nodeCache.reserve(numNodes + 2);
+
+  for(int i = 0; i < numNodes; i++)
+  {
+    const SnapshotNode& n = nodes[i];
+    Node node;
+    node.id = n.id;
+    if(airwayRouting)
+    {
+      node.type = static_cast<nw::NodeType>(n.type >> 4);
+      node.subtype = static_cast<nw::NodeType>(n.type & 0x0f);
+    }
+    else
+      node.type = static_cast<nw::NodeType>(n.type);
+    node.range = n.range;
+    node.pos.setLonX(n.lonx);
+    node.pos.setLatY(n.laty);
+    nodeCache.insert(node.id, node);
+  }
+
+  for(int i = 0; i < numEdges; i++)
+  {
+    const SnapshotEdge& e = edges[i];
+    if(e.fromNodeId == e.toNodeId)
+      continue;
+
+    Edge edge;
+    edge.type = static_cast<nw::EdgeType>(e.type);
+    edge.minAltFt = e.minAltFt;
+    edge.airwayId = e.airwayId;
+    edge.lengthMeter = e.lengthMeter;
+    if(e.airwayName >= 0 && e.airwayName < airwayNames.size())
+      edge.airwayName = airwayNames.at(e.airwayName);
+
+    auto fromIt = nodeCache.find(e.fromNodeId);
+    if(fromIt != nodeCache.end() && testType(static_cast<nw::NodeType>(e.toNodeType)))
+    {
+      // Outgoing edge
+      edge.toNodeId = e.toNodeId;
+      fromIt->edges.append(edge);
+    }
+
+    auto toIt = nodeCache.find(e.toNodeId);
+    if(toIt != nodeCache.end() && testType(static_cast<nw::NodeType>(e.fromNodeType)))
+    {
+      // Ingoing edge
+      edge.toNodeId = e.fromNodeId;
+      toIt->edges.append(edge);
+    }
+  }
+
+  for(auto it = nodeCache.begin(); it != nodeCache.end(); ++it)
+  {
+    // Remove duplicates which result from edges that are stored in both directions
+    QVector<Edge>& nodeEdges = it->edges;
+    std::sort(nodeEdges.begin(), nodeEdges.end(), [](const Edge& e1, const Edge& e2) -> bool
+              {
+                return e1.toNodeId < e2.toNodeId || (e1.toNodeId == e2.toNodeId && e1.type < e2.type);
+              });
+    nodeEdges.erase(std::unique(nodeEdges.begin(), nodeEdges.end()), nodeEdges.end());
+    nodeEdges.squeeze();
+
+    if(destinationPos.isValid())
+      addDestNodeEdges(*it);
+  }
+
+  numNodesDb = numNodes;
+}
+
+bool RouteNetwork::readSnapshot(const QString& filename, const SnapshotHeader& expected)
+{
+  QFile file(filename);
+  if(!file.exists())
+    return false;
+
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    qWarning() << "Cannot open network snapshot" << filename << ":" << file.errorString();
+    return false;
+  }
+
+  bool valid = false;
+  qint64 size = file.size();
+  uchar *data = size >= static_cast<qint64>(sizeof(SnapshotHeader)) ? file.map(0, size) : nullptr;
+  if(data != nullptr)
+  {
+    SnapshotHeader header;
+    memcpy(&header, data, sizeof(SnapshotHeader));
+
+    valid = header.magic == expected.magic && header.version == expected.version &&
+            header.databaseSize == expected.databaseSize && header.databaseModified == expected.databaseModified &&
+            size == static_cast<qint64>(sizeof(SnapshotHeader) + header.numNodes * sizeof(SnapshotNode) +
+                                        header.numEdges * sizeof(SnapshotEdge) + header.namesSize);
+
+    if(valid)
+    {
+      // Use the mapped arrays directly
+      const SnapshotNode *nodes = reinterpret_cast<const SnapshotNode *>(data + sizeof(SnapshotHeader));
+      const SnapshotEdge *edges = reinterpret_cast<const SnapshotEdge *>(nodes + header.numNodes);
+      const char *names = reinterpret_cast<const char *>(edges + header.numEdges);
+
+      QStringList airwayNames;
+      if(header.namesSize > 0)
+        airwayNames = QString::fromUtf8(names, static_cast<int>(header.namesSize)).split('\n');
+
+      fillCache(nodes, static_cast<int>(header.numNodes), edges, static_cast<int>(header.numEdges), airwayNames);
+    }
+    else
+      qInfo() << "Network snapshot" << filename << "is outdated";
+
+    file.unmap(data);
+  }
+  else
+    qWarning() << "Cannot map network snapshot" << filename << ":" << file.errorString();
+
+  file.close();
+  return valid;
+}
+
+void RouteNetwork::writeSnapshot(const QString& filename, const SnapshotHeader& header,
+                                 const QVector<SnapshotNode>& nodes, const QVector<SnapshotEdge>& edges,
+                                 const QStringList& airwayNames)
+{
+  QByteArray names = airwayNames.join('\n').toUtf8();
+
+  SnapshotHeader fileHeader(header);
+  fileHeader.numNodes = static_cast<quint32>(nodes.size());
+  fileHeader.numEdges = static_cast<quint32>(edges.size());
+  fileHeader.namesSize = static_cast<quint32>(names.size());
+
+  QSaveFile file(filename);
+  if(file.open(QIODevice::WriteOnly))
+  {
+    file.write(reinterpret_cast<const char *>(&fileHeader), sizeof(SnapshotHeader));
+    file.write(reinterpret_cast<const char *>(nodes.constData()), nodes.size() * sizeof(SnapshotNode));
+    file.write(reinterpret_cast<const char *>(edges.constData()), edges.size() * sizeof(SnapshotEdge));
+    file.write(names);
+
+    if(!file.commit())
+      qWarning() << "Cannot write network snapshot" << filename << ":" << file.errorString();
+  }
+  else
+    qWarning() << "Cannot open network snapshot" << filename << ":" << file.errorString();
+}
@@ -188,6 +188,9 @@ public:
   /* Integrate departure and destination positions into the network as virtual nodes/edges */
   void addDepartureAndDestinationNodes(const atools::geo::Pos& from, const atools::geo::Pos& to);
 
+  /* Remove the virtual departure and destination nodes and all edges to them but keep the loaded network */
+  void removeDepartureAndDestinationNodes();
+
   /* Get the virtual departure node that was added using addDepartureAndDestinationNodes */
   nw::Node getDepartureNode() const;
 
@@ -203,6 +206,20 @@ public:
   /* Number of nodes in the memory cache */
   int getNumberOfNodesCache() const;
 
+  /* Number of edges of all nodes in the memory cache */
+  int getNumberOfEdgesCache() const;
+
+  /* Number of SQL queries executed since the last reset. Used for statistics. */
+  int getNumQueries() const
+  {
+    return numQueries;
+  }
+
+  void resetNumQueries()
+  {
+    numQueries = 0;
+  }
+
   /* true if mode is either ROUTE_VICTOR, ROUTE_JET  or both flags */
   bool isAirwayRouting() const
   {
@@ -212,9 +229,51 @@ public:
   /* Sets the route mode. This will change some internal behavior like checking subtypes and more */
   void setMode(nw::Modes routeMode);
 
+  /* Load all nodes and edges into the cache at once. Reads the snapshot file if it matches the
+   * database. Otherwise the network is read with two bulk queries and a new snapshot file is written.
+   * Called automatically on first use after a database change. */
+  void loadNetwork();
+
+  /* Do not read or write the snapshot file if false. Default is true. */
+  void setSnapshotEnabled(bool value)
+  {
+    snapshotEnabled = value;
+  }
+
 private:
+  /* Snapshot file header. Database size and modification time are used to detect outdated files. */
+  struct SnapshotHeader
+  {
+    quint32 magic, version;
+    qint64 databaseSize, databaseModified;
+    quint32 numNodes, numEdges, namesSize, reserved;
+  };
+
+  /* Node as stored in the snapshot file. Type is not decoded. */
+  struct SnapshotNode
+  {
+    qint32 id, type, range;
+    float lonx, laty;
+  };
+
+  /* Edge as stored in the snapshot file. Airway name is an index into the interned name list. */
+  struct SnapshotEdge
+  {
+    qint32 fromNodeId, fromNodeType, toNodeId, toNodeType, type, minAltFt, airwayId, airwayName, lengthMeter;
+  };
+
   void clearStartAndDestinationNodes();
 
+  /* Fill the node cache from the flat snapshot arrays */
+  void fillCache(const SnapshotNode *nodes, int numNodes, const SnapshotEdge *edges, int numEdges,
+                 const QStringList& airwayNames);
+
+  bool readSnapshot(const QString& filename, const SnapshotHeader& expected);
+  void writeSnapshot(const QString& filename, const SnapshotHeader& header, const QVector<SnapshotNode>& nodes,
+                     const QVector<SnapshotEdge>& edges, const QStringList& airwayNames);
+  void loadNetworkDatabase(QVector<SnapshotNode>& nodes, QVector<SnapshotEdge>& edges, QStringList& airwayNames);
+  QString getSnapshotFilename() const;
+
   nw::Node fetchNodeByNavId(int id, nw::NodeType type);
   nw::Node fetchNode(int id);
   nw::Node fetchNode(float lonx, float laty, bool loadSuccessors, int id);
@@ -241,6 +300,9 @@ private:
   /* Cache the number of nodes in the database */
   int numNodesDb = -1;
 
+  /* Number of executed queries for statistics */
+  int numQueries = 0;
+
   atools::sql::SqlQuery *nodeByNavIdQuery = nullptr, *nodeNavIdAndTypeQuery = nullptr,
   *nearestNodesQuery = nullptr, *nodeByIdQuery = nullptr, *edgeToQuery = nullptr,
   *edgeFromQuery = nullptr;
@@ -255,8 +317,12 @@ private:
   atools::sql::SqlDatabase *db;
   nw::Modes mode;
 
-  /* Cache for nodes (also containing edges) for the whole network. Filled on demand. */
+  /* Cache for nodes (also containing edges) for the whole network. Filled by loadNetwork. */
   QHash<int, nw::Node> nodeCache;
+  bool networkLoaded = false, snapshotEnabled = true;
+
+  static Q_DECL_CONSTEXPR quint32 SNAPSHOT_MAGIC_NUMBER = 0x4E524E4C;
+  static Q_DECL_CONSTEXPR quint32 SNAPSHOT_VERSION = 1;
 
   /* Database tables and extra columns */
   QString nodeTable, edgeTable;
@@ -23,7 +23,9 @@
 #include "route/flightplanentrybuilder.h"
 #include "common/maptools.h"
 #include "common/unit.h"
+#include "common/formatter.h"
 
+#include <QElapsedTimer>
 #include <QRegularExpression>
 
 using atools::fs::pln::Flightplan;
@@ -179,6 +181,9 @@ bool RouteString::createRouteFromString(const QString& routeString, atools::fs::
                                         float& speedKts)
 {
   // qDebug() << Q_FUNC_INFO;
+  QElapsedTimer timer;
+  timer.start();
+
   messages.clear();
   QStringList items = cleanRouteString(routeString);
 
@@ -213,13 +218,23 @@ bool RouteString::createRouteFromString(const QString& routeString, atools::fs::
     atools::geo::nmToMeter(std::max(MAX_WAYPOINT_DISTANCE_NM,
                                     atools::roundToInt(flightplan.getDistanceNm() * 1.5f)));
 
+  // Resolve all idents and airway names with one query per type
+  QHash<QString, MapSearchResult> identResults;
+  QStringList idents;
+  for(const QString& item : cleanItems)
+  {
+    if(item.length() <= 5)
+      idents.append(item);
+  }
+  query->getMapObjectsByIdents(identResults, ROUTE_TYPES, idents);
+
   // Collect all navaids, airports and coordinates
   atools::geo::Pos lastPos(flightplan.getDeparturePosition());
   QList<ParseEntry> resultList;
   for(const QString& item : cleanItems)
   {
     MapSearchResult result;
-    findWaypoints(result, item);
+    findWaypoints(result, identResults, item);
 
     // Sort lists by distance and remove all which are too far away and update last pos
     filterWaypoints(result, lastPos, maxDistance);
@@ -297,6 +312,8 @@ bool RouteString::createRouteFromString(const QString& routeString, atools::fs::
     lastPos = flightplan.getEntries().at(flightplan.getEntries().size() - 2).getPosition();
   }
 
+  qDebug() << Q_FUNC_INFO << "parsed" << cleanItems.size() << "items in" << formatter::formatElapsed(timer);
+
   return true;
 }
 
@@ -564,7 +581,8 @@ void RouteString::filterAirways(QList<ParseEntry>& resultList, int i)
   }
 }
 
-void RouteString::findWaypoints(MapSearchResult& result, const QString& item)
+void RouteString::findWaypoints(MapSearchResult& result, const QHash<QString, MapSearchResult>& identResults,
+                                const QString& item)
 {
   if(item.length() > 5)
   {
@@ -579,7 +597,7 @@ void RouteString::findWaypoints(MapSearchResult& result, const QString& item)
   }
   else
   {
-    query->getMapObjectByIdent(result, ROUTE_TYPES, item);
+    result = identResults.value(item);
 
     if(item.length() == 5 && result.waypoints.isEmpty())
     {
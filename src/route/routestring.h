@@ -20,6 +20,7 @@
 
 #include "common/maptypes.h"
 
+#include <QHash>
 #include <QStringList>
 #include <QApplication>
 
@@ -86,7 +87,8 @@ private:
                         int startIndex, int endIndex,
                         QList<maptypes::MapWaypoint>& airwayWaypoints);
   QStringList createStringForRouteInternal(const RouteMapObjectList& route, float speed, bool gfpFormat);
-  void findWaypoints(maptypes::MapSearchResult& result, const QString& item);
+  void findWaypoints(maptypes::MapSearchResult& result,
+                     const QHash<QString, maptypes::MapSearchResult>& identResults, const QString& item);
   void filterWaypoints(maptypes::MapSearchResult& result, atools::geo::Pos& lastPos, int maxDistance);
   void filterAirways(QList<ParseEntry>& resultList, int i);
   QStringList cleanItemList(const QStringList& items, float& speedKnots, float& altFeet);
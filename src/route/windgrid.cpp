@@ -0,0 +1,206 @@
+/*****************************************************************************
+* Copyright 2015-2017 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "route/windgrid.h"
+
+#include "geo/pos.h"
+#include "geo/calculations.h"
+#include "atools.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QRegularExpression>
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+/* One altitude level at a grid point */
+struct WindLevel
+{
+  float altitudeFt, u, v;
+};
+
+}
+
+WindGrid::WindGrid()
+{
+
+}
+
+WindGrid::~WindGrid()
+{
+
+}
+
+void WindGrid::clear()
+{
+  uGrid.clear();
+  vGrid.clear();
+  maxSpeed = 0.f;
+}
+
+bool WindGrid::load(const QString& filename, float altitudeFt)
+{
+  clear();
+
+  QFile file(filename);
+  if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+  {
+    qWarning() << "Cannot open wind file" << filename << ":" << file.errorString();
+    return false;
+  }
+
+  // Collect all levels for each grid point
+  QVector<QVector<WindLevel> > levels(GRID_WIDTH * GRID_HEIGHT);
+  static const QRegularExpression SEPARATOR("[\\s,;]+");
+
+  QTextStream stream(&file);
+  QString line;
+  int lineNum = 0, numValues = 0;
+  while(stream.readLineInto(&line))
+  {
+    lineNum++;
+    line = line.trimmed();
+    if(line.isEmpty() || line.startsWith('#'))
+      continue;
+
+    QStringList values = line.split(SEPARATOR, QString::SkipEmptyParts);
+    bool okLat = false, okLon = false, okAlt = false, okDir = false, okSpeed = false;
+    if(values.size() >= 5)
+    {
+      float laty = values.at(0).toFloat(&okLat);
+      float lonx = values.at(1).toFloat(&okLon);
+      float alt = values.at(2).toFloat(&okAlt);
+      float dir = values.at(3).toFloat(&okDir);
+      float speed = values.at(4).toFloat(&okSpeed);
+
+      if(okLat && okLon && okAlt && okDir && okSpeed && laty >= -90.f && laty <= 90.f)
+      {
+        // Direction is where the wind comes from
+        float dirRad = atools::geo::toRadians(dir);
+        int x = (atools::roundToInt(lonx) + 180 + GRID_WIDTH) % GRID_WIDTH;
+        int y = atools::roundToInt(laty) + 90;
+        levels[index(x, y)].append({alt, -speed * std::sin(dirRad), -speed * std::cos(dirRad)});
+        numValues++;
+        continue;
+      }
+    }
+    qWarning() << "Invalid line" << lineNum << "in wind file" << filename << ":" << line;
+  }
+  file.close();
+
+  if(numValues == 0)
+    return false;
+
+  uGrid.fill(0.f, GRID_WIDTH * GRID_HEIGHT);
+  vGrid.fill(0.f, GRID_WIDTH * GRID_HEIGHT);
+
+  // Interpolate levels to the requested altitude
+  for(int i = 0; i < levels.size(); i++)
+  {
+    QVector<WindLevel>& pointLevels = levels[i];
+    if(pointLevels.isEmpty())
+      continue;
+
+    std::sort(pointLevels.begin(), pointLevels.end(), [](const WindLevel& l1, const WindLevel& l2) -> bool
+              {
+                return l1.altitudeFt < l2.altitudeFt;
+              });
+
+    float u, v;
+    if(altitudeFt <= pointLevels.first().altitudeFt)
+    {
+      u = pointLevels.first().u;
+      v = pointLevels.first().v;
+    }
+    else if(altitudeFt >= pointLevels.last().altitudeFt)
+    {
+      u = pointLevels.last().u;
+      v = pointLevels.last().v;
+    }
+    else
+    {
+      int upper = 1;
+      while(pointLevels.at(upper).altitudeFt < altitudeFt)
+        upper++;
+
+      const WindLevel& l1 = pointLevels.at(upper - 1);
+      const WindLevel& l2 = pointLevels.at(upper);
+      float fraction = (altitudeFt - l1.altitudeFt) / (l2.altitudeFt - l1.altitudeFt);
+      u = l1.u + (l2.u - l1.u) * fraction;
+      v = l1.v + (l2.v - l1.v) * fraction;
+    }
+
+    uGrid[i] = u;
+    vGrid[i] = v;
+    maxSpeed = std::max(maxSpeed, std::sqrt(u * u + v * v));
+  }
+
+  qDebug() << Q_FUNC_INFO << "loaded" << numValues << "wind values from" << filename
+           << "for altitude" << altitudeFt << "max speed" << maxSpeed;
+  return true;
+}
+
+void WindGrid::windAt(const atools::geo::Pos& pos, float& u, float& v) const
+{
+  if(isEmpty())
+  {
+    u = 0.f;
+    v = 0.f;
+    return;
+  }
+
+  float x = pos.getLonX() + 180.f;
+  float y = std::max(0.f, std::min(pos.getLatY() + 90.f, static_cast<float>(GRID_HEIGHT - 1)));
+
+  int x0 = static_cast<int>(std::floor(x));
+  int y0 = std::min(static_cast<int>(std::floor(y)), GRID_HEIGHT - 2);
+  float fx = x - x0, fy = y - y0;
+
+  // Wrap around at the anti meridian
+  x0 = (x0 % GRID_WIDTH + GRID_WIDTH) % GRID_WIDTH;
+  int x1 = (x0 + 1) % GRID_WIDTH;
+  int y1 = y0 + 1;
+
+  int i00 = index(x0, y0), i10 = index(x1, y0), i01 = index(x0, y1), i11 = index(x1, y1);
+
+  u = (uGrid.at(i00) * (1.f - fx) + uGrid.at(i10) * fx) * (1.f - fy) +
+      (uGrid.at(i01) * (1.f - fx) + uGrid.at(i11) * fx) * fy;
+  v = (vGrid.at(i00) * (1.f - fx) + vGrid.at(i10) * fx) * (1.f - fy) +
+      (vGrid.at(i01) * (1.f - fx) + vGrid.at(i11) * fx) * fy;
+}
+
+float WindGrid::groundSpeed(const atools::geo::Pos& pos, float courseDegTrue, float trueAirspeedKts) const
+{
+  float u, v;
+  windAt(pos, u, v);
+
+  float courseRad = atools::geo::toRadians(courseDegTrue);
+  float sinCourse = std::sin(courseRad), cosCourse = std::cos(courseRad);
+
+  // Split wind into tailwind and crosswind component
+  float tailwind = u * sinCourse + v * cosCourse;
+  float crosswind = u * cosCourse - v * sinCourse;
+
+  // Crosswind needs a correction angle which reduces speed along the course
+  float alongTrack = std::sqrt(std::max(trueAirspeedKts * trueAirspeedKts - crosswind * crosswind, 0.f));
+
+  // Avoid zero or negative ground speeds for extreme winds
+  return std::max(alongTrack + tailwind, trueAirspeedKts * 0.1f);
+}
@@ -0,0 +1,82 @@
+/*****************************************************************************
+* Copyright 2015-2017 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_WINDGRID_H
+#define LITTLENAVMAP_WINDGRID_H
+
+#include <QVector>
+#include <QString>
+
+namespace atools {
+namespace geo {
+class Pos;
+}
+}
+
+/*
+ * Wind field for one altitude on a global one degree grid. Used by the route finder to calculate
+ * travel time instead of distance.
+ *
+ * Winds are loaded from a text file with one value per line:
+ * "latitude longitude altitude direction speed"
+ * Altitude is in feet, direction in degree true (wind from) and speed in knots. Values can be separated by
+ * spaces, commas or semicolons. Lines starting with "#" are ignored. Positions are rounded to the next full
+ * degree and several altitude levels are interpolated to the requested altitude when loading.
+ */
+class WindGrid
+{
+public:
+  WindGrid();
+  ~WindGrid();
+
+  /* Load wind file and interpolate all levels to altitudeFt. Returns false if the file cannot be read. */
+  bool load(const QString& filename, float altitudeFt);
+
+  void clear();
+
+  bool isEmpty() const
+  {
+    return uGrid.isEmpty();
+  }
+
+  /* Wind components at position in knots with bilinear interpolation. u is east and v is north component. */
+  void windAt(const atools::geo::Pos& pos, float& u, float& v) const;
+
+  /* Ground speed in knots for the given true course at the position */
+  float groundSpeed(const atools::geo::Pos& pos, float courseDegTrue, float trueAirspeedKts) const;
+
+  /* Highest wind speed in the grid in knots */
+  float getMaxSpeed() const
+  {
+    return maxSpeed;
+  }
+
+private:
+  int index(int lonX, int latY) const
+  {
+    return latY * GRID_WIDTH + lonX;
+  }
+
+  static Q_DECL_CONSTEXPR int GRID_WIDTH = 360;
+  static Q_DECL_CONSTEXPR int GRID_HEIGHT = 181;
+
+  /* East and north components in knots. Index is (latitude + 90) * 360 + longitude + 180 */
+  QVector<float> uGrid, vGrid;
+  float maxSpeed = 0.f;
+};
+
+#endif // LITTLENAVMAP_WINDGRID_H
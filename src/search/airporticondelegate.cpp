@@ -19,10 +19,10 @@
 
 #include "options/optiondata.h"
 #include "search/sqlmodel.h"
-#include "search/sqlproxymodel.h"
 #include "common/symbolpainter.h"
 #include "sql/sqlrecord.h"
 #include "common/maptypesfactory.h"
+#include "atools.h"
 
 #include <QPainter>
 
@@ -42,21 +42,15 @@ AirportIconDelegate::~AirportIconDelegate()
 void AirportIconDelegate::paint(QPainter *painter, const QStyleOptionViewItem& option,
                                 const QModelIndex& index) const
 {
-  QModelIndex idx(index);
-  const SqlModel *sqlModel = dynamic_cast<const SqlModel *>(index.model());
-  if(sqlModel == nullptr)
-  {
-    // Convert index to source if distance search proxy is used
-    const SqlProxyModel *sqlProxyModel = dynamic_cast<const SqlProxyModel *>(index.model());
-    Q_ASSERT(sqlProxyModel != nullptr);
-    sqlModel = dynamic_cast<const SqlModel *>(sqlProxyModel->sourceModel());
-    idx = sqlProxyModel->mapToSource(index);
-  }
-  Q_ASSERT(sqlModel != nullptr);
+  updateModel(index.model());
+
+  int row = sourceRow(index);
 
   // Get airport from the SQL model
+  const AirportRow& airportRowData = airportRow(sqlModel, row);
   maptypes::MapAirport ap;
-  mapTypesFactory->fillAirport(sqlModel->getSqlRecord(idx.row()), ap, true);
+  ap.flags = airportRowData.flags;
+  ap.longestRunwayLength = airportRowData.longestRunwayLength;
 
   // Create a style copy
   QStyleOptionViewItem opt(option);
@@ -72,8 +66,56 @@ void AirportIconDelegate::paint(QPainter *painter, const QStyleOptionViewItem& o
   // Draw the text
   QStyledItemDelegate::paint(painter, opt, index);
 
-  // Draw the symbol
+  // Draw the symbol centered at the same position as before
   int symbolSize = option.rect.height() - 4;
-  symbolPainter->drawAirportSymbol(painter, ap, option.rect.x() + symbolSize,
-                                   option.rect.y() + symbolSize / 2 + 2, symbolSize, false, false);
+  const QPixmap *pixmap = airportSymbol(ap, symbolSize, painter->device()->devicePixelRatioF());
+  painter->drawPixmap(option.rect.x(), option.rect.y() + symbolSize / 2 + 2 - symbolSize, *pixmap);
+}
+
+const AirportIconDelegate::AirportRow& AirportIconDelegate::airportRow(const SqlModel *model, int row) const
+{
+  auto it = rowCache.constFind(row);
+  if(it == rowCache.constEnd())
+  {
+    maptypes::MapAirport ap;
+    mapTypesFactory->fillAirport(model->getSqlRecord(row), ap, true);
+    it = rowCache.insert(row, {ap.flags, ap.longestRunwayLength});
+  }
+  return it.value();
+}
+
+const QPixmap *AirportIconDelegate::airportSymbol(const maptypes::MapAirport& airport, int size,
+                                                  qreal pixelRatio) const
+{
+  // Empty airport option changes the symbol color
+  bool emptyOption = OptionData::instance().getFlags() & opts::MAP_EMPTY_AIRPORTS;
+
+  quint64 key = static_cast<quint64>(static_cast<quint32>(airport.flags)) |
+                (static_cast<quint64>(airport.longestRunwayLength == 0) << 32) |
+                (static_cast<quint64>(emptyOption) << 33) |
+                (static_cast<quint64>(size & 0xffff) << 34) |
+                (static_cast<quint64>(atools::roundToInt(pixelRatio * 100.) & 0xffff) << 50);
+
+  QPixmap *pixmap = symbolCache.object(key);
+  if(pixmap == nullptr)
+  {
+    // Leave enough space for the fuel spikes around the symbol
+    int pixmapSize = size * 2;
+    pixmap = new QPixmap(QSize(pixmapSize, pixmapSize) * pixelRatio);
+    pixmap->setDevicePixelRatio(pixelRatio);
+    pixmap->fill(Qt::transparent);
+
+    QPainter painter(pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    symbolPainter->drawAirportSymbol(&painter, airport, size, size, size, false, false);
+    painter.end();
+
+    symbolCache.insert(key, pixmap);
+  }
+  return pixmap;
+}
+
+void AirportIconDelegate::clearRowCache()
+{
+  rowCache.clear();
 }
@@ -18,7 +18,11 @@
 #ifndef LITTLENAVMAP_AIRPORTICONDELEGATE_H
 #define LITTLENAVMAP_AIRPORTICONDELEGATE_H
 
-#include <QStyledItemDelegate>
+#include "common/maptypes.h"
+#include "search/searchicondelegate.h"
+
+#include <QCache>
+#include <QHash>
 
 class ColumnList;
 class SymbolPainter;
@@ -28,7 +32,7 @@ class MapTypesFactory;
  * Paints airport icons into the "ident" cell of the search result table view.
  */
 class AirportIconDelegate :
-  public QStyledItemDelegate
+  public SearchIconDelegate
 {
   Q_OBJECT
 
@@ -37,13 +41,34 @@ public:
   virtual ~AirportIconDelegate();
 
 private:
+  /* Airport values needed for text style and symbol of one table row */
+  struct AirportRow
+  {
+    maptypes::MapAirportFlags flags;
+    int longestRunwayLength;
+  };
+
   virtual void paint(QPainter *painter, const QStyleOptionViewItem& option,
                      const QModelIndex& index) const override;
 
+  /* Get values for the row from cache or decode them from the SQL record */
+  const AirportRow& airportRow(const SqlModel *sqlModel, int row) const;
+
+  /* Get rendered symbol from cache or draw it */
+  const QPixmap *airportSymbol(const maptypes::MapAirport& airport, int size, qreal pixelRatio) const;
+
+  virtual void clearRowCache() override;
+
   const ColumnList *cols;
   SymbolPainter *symbolPainter;
   MapTypesFactory *mapTypesFactory;
 
+  /* Decoded rows of the SQL model. Cleared when the query is reset. */
+  mutable QHash<int, AirportRow> rowCache;
+
+  /* Rendered symbols. Key contains airport flags, runway state, size and pixel ratio. */
+  mutable QCache<quint64, QPixmap> symbolCache;
+
 };
 
 #endif // LITTLENAVMAP_AIRPORTICONDELEGATE_H
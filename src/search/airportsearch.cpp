@@ -378,16 +378,18 @@ QVariant AirportSearch::modelDataHandler(int colIndex, int rowIndex, const Colum
       return formatModelData(col, displayRoleValue);
 
     case Qt::TextAlignmentRole:
-      if(col->getColumnName() == "rating")
-        return Qt::AlignLeft;
-      else if(col->getColumnName() == "ident" ||
-              displayRoleValue.type() == QVariant::Int || displayRoleValue.type() == QVariant::UInt ||
-              displayRoleValue.type() == QVariant::LongLong || displayRoleValue.type() ==
-              QVariant::ULongLong ||
-              displayRoleValue.type() == QVariant::Double)
-        // Align all numeric columns right
-        return Qt::AlignRight;
-
+      {
+        ColumnFormat format = columnFormat(col);
+        if(format == FORMAT_RATING)
+          return Qt::AlignLeft;
+        else if(format == FORMAT_IDENT ||
+                displayRoleValue.type() == QVariant::Int || displayRoleValue.type() == QVariant::UInt ||
+                displayRoleValue.type() == QVariant::LongLong || displayRoleValue.type() ==
+                QVariant::ULongLong ||
+                displayRoleValue.type() == QVariant::Double)
+          // Align all numeric columns right
+          return Qt::AlignRight;
+      }
       break;
     case Qt::BackgroundRole:
       if(colIndex == controller->getSortColumnIndex())
@@ -402,36 +404,83 @@ QVariant AirportSearch::modelDataHandler(int colIndex, int rowIndex, const Colum
   return QVariant();
 }
 
+/* Get the formatting for a column and remember it */
+AirportSearch::ColumnFormat AirportSearch::columnFormat(const Column *col) const
+{
+  auto it = columnFormats.constFind(col);
+  if(it != columnFormats.constEnd())
+    return it.value();
+
+  const QString& name = col->getColumnName();
+  ColumnFormat format = FORMAT_DEFAULT;
+  if(name == "tower_frequency" || name == "atis_frequency" || name == "awos_frequency" ||
+     name == "asos_frequency" || name == "unicom_frequency")
+    format = FORMAT_FREQUENCY;
+  else if(name == "altitude")
+    format = FORMAT_ALTITUDE;
+  else if(name == "longest_runway_length")
+    format = FORMAT_RUNWAY_LENGTH;
+  else if(name == "mag_var")
+    format = FORMAT_MAGVAR;
+  else if(NUMBER_COLUMNS.contains(name))
+    format = FORMAT_NUMBER;
+  else if(name == "longest_runway_surface")
+    format = FORMAT_SURFACE;
+  else if(name == "largest_parking_ramp")
+    format = FORMAT_PARKING_RAMP;
+  else if(name == "largest_parking_gate")
+    format = FORMAT_PARKING_GATE;
+  else if(name == "rating")
+    format = FORMAT_RATING;
+  else if(name == "ident")
+    format = FORMAT_IDENT;
+
+  columnFormats.insert(col, format);
+  return format;
+}
+
 /* Formats the QVariant to a QString depending on column name */
 QString AirportSearch::formatModelData(const Column *col, const QVariant& displayRoleValue) const
 {
   // Called directly by the model for export functions
-  if(col->getColumnName() == "tower_frequency" || col->getColumnName() == "atis_frequency" ||
-     col->getColumnName() == "awos_frequency" || col->getColumnName() == "asos_frequency" ||
-     col->getColumnName() == "unicom_frequency")
+  switch(columnFormat(col))
   {
-    if(displayRoleValue.isNull())
-      return QString();
-    else
-      return QLocale().toString(displayRoleValue.toDouble() / 1000, 'f', 3);
+    case FORMAT_FREQUENCY:
+      if(displayRoleValue.isNull())
+        return QString();
+      else
+        return QLocale().toString(displayRoleValue.toDouble() / 1000, 'f', 3);
+
+    case FORMAT_ALTITUDE:
+      return Unit::altFeet(displayRoleValue.toFloat(), false);
+
+    case FORMAT_RUNWAY_LENGTH:
+      return Unit::distShortFeet(displayRoleValue.toFloat(), false);
+
+    case FORMAT_MAGVAR:
+      return maptypes::magvarText(displayRoleValue.toFloat());
+
+    case FORMAT_NUMBER:
+      return displayRoleValue.toInt() > 0 ? displayRoleValue.toString() : QString();
+
+    case FORMAT_SURFACE:
+      return maptypes::surfaceName(displayRoleValue.toString());
+
+    case FORMAT_PARKING_RAMP:
+      return maptypes::parkingRampName(displayRoleValue.toString());
+
+    case FORMAT_PARKING_GATE:
+      return maptypes::parkingGateName(displayRoleValue.toString());
+
+    case FORMAT_RATING:
+      return atools::ratingString(displayRoleValue.toInt(), 5);
+
+    case FORMAT_IDENT:
+    case FORMAT_DEFAULT:
+      break;
   }
-  else if(col->getColumnName() == "altitude")
-    return Unit::altFeet(displayRoleValue.toFloat(), false);
-  else if(col->getColumnName() == "longest_runway_length")
-    return Unit::distShortFeet(displayRoleValue.toFloat(), false);
-  else if(col->getColumnName() == "mag_var")
-    return maptypes::magvarText(displayRoleValue.toFloat());
-  else if(NUMBER_COLUMNS.contains(col->getColumnName()))
-    return displayRoleValue.toInt() > 0 ? displayRoleValue.toString() : QString();
-  else if(col->getColumnName() == "longest_runway_surface")
-    return maptypes::surfaceName(displayRoleValue.toString());
-  else if(col->getColumnName() == "largest_parking_ramp")
-    return maptypes::parkingRampName(displayRoleValue.toString());
-  else if(col->getColumnName() == "largest_parking_gate")
-    return maptypes::parkingGateName(displayRoleValue.toString());
-  else if(col->getColumnName() == "rating")
-    return atools::ratingString(displayRoleValue.toInt(), 5);
-  else if(displayRoleValue.type() == QVariant::Int || displayRoleValue.type() == QVariant::UInt)
+
+  if(displayRoleValue.type() == QVariant::Int || displayRoleValue.type() == QVariant::UInt)
     return QLocale().toString(displayRoleValue.toInt());
   else if(displayRoleValue.type() == QVariant::LongLong || displayRoleValue.type() == QVariant::ULongLong)
     return QLocale().toString(displayRoleValue.toLongLong());
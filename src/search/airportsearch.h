@@ -21,6 +21,7 @@
 #include "search/searchbase.h"
 
 #include <QObject>
+#include <QHash>
 
 class Column;
 class AirportIconDelegate;
@@ -63,8 +64,29 @@ private:
                             const QVariant& displayRoleValue, Qt::ItemDataRole role) const;
   QString formatModelData(const Column *col, const QVariant& displayRoleValue) const;
 
+  /* Formatting for a column. Resolved once per column to avoid string comparisons for each table cell. */
+  enum ColumnFormat
+  {
+    FORMAT_DEFAULT,
+    FORMAT_IDENT,
+    FORMAT_FREQUENCY,
+    FORMAT_ALTITUDE,
+    FORMAT_RUNWAY_LENGTH,
+    FORMAT_MAGVAR,
+    FORMAT_NUMBER,
+    FORMAT_SURFACE,
+    FORMAT_PARKING_RAMP,
+    FORMAT_PARKING_GATE,
+    FORMAT_RATING
+  };
+
+  ColumnFormat columnFormat(const Column *col) const;
+
   static const QSet<QString> NUMBER_COLUMNS;
 
+  /* Maps columns to formatting. Columns are owned by the column list and do not change. */
+  mutable QHash<const Column *, ColumnFormat> columnFormats;
+
   /* All layouts, lines and drop down menu items */
   QList<QObject *> airportSearchWidgets;
 
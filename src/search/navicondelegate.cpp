@@ -18,10 +18,10 @@
 #include "search/navicondelegate.h"
 
 #include "search/sqlmodel.h"
-#include "search/sqlproxymodel.h"
 #include "common/symbolpainter.h"
 #include "sql/sqlrecord.h"
 #include "common/maptypes.h"
+#include "atools.h"
 
 #include <QPainter>
 
@@ -39,17 +39,9 @@ NavIconDelegate::~NavIconDelegate()
 void NavIconDelegate::paint(QPainter *painter, const QStyleOptionViewItem& option,
                             const QModelIndex& index) const
 {
-  QModelIndex idx(index);
-  const SqlModel *sqlModel = dynamic_cast<const SqlModel *>(index.model());
-  if(sqlModel == nullptr)
-  {
-    // Convert index to source if distance search proxy is used
-    const SqlProxyModel *sqlProxyModel = dynamic_cast<const SqlProxyModel *>(index.model());
-    Q_ASSERT(sqlProxyModel != nullptr);
-    sqlModel = dynamic_cast<const SqlModel *>(sqlProxyModel->sourceModel());
-    idx = sqlProxyModel->mapToSource(index);
-  }
-  Q_ASSERT(sqlModel != nullptr);
+  updateModel(index.model());
+
+  int row = sourceRow(index);
 
   // Create a style copy
   QStyleOptionViewItem opt(option);
@@ -62,24 +54,80 @@ void NavIconDelegate::paint(QPainter *painter, const QStyleOptionViewItem& optio
   // Draw the text
   QStyledItemDelegate::paint(painter, opt, index);
 
-  // Get nav type from SQL model
-  QString navtype = sqlModel->getSqlRecord(idx.row()).valueStr("nav_type");
-  maptypes::MapObjectTypes type = maptypes::navTypeToMapObjectType(navtype);
+  NavSymbol symbol = navSymbol(row);
+  if(symbol == NONE)
+    return;
 
+  // Draw the symbol centered at the same position as before
   int symbolSize = option.rect.height() - 4;
-  int x = option.rect.x() + symbolSize;
-  int y = option.rect.y() + symbolSize / 2 + 2;
-
-  if(type == maptypes::WAYPOINT)
-    // An empty waypoint is enough to draw the symbol
-    symbolPainter->drawWaypointSymbol(painter, QColor(), x, y, symbolSize, false, false);
-  else if(type == maptypes::NDB)
-    symbolPainter->drawNdbSymbol(painter, x, y, symbolSize, false, false);
-  else if(type == maptypes::VOR)
+  const QPixmap *pixmap = navSymbolPixmap(symbol, symbolSize, painter->device()->devicePixelRatioF());
+  painter->drawPixmap(option.rect.x(), option.rect.y() + symbolSize / 2 + 2 - symbolSize, *pixmap);
+}
+
+NavIconDelegate::NavSymbol NavIconDelegate::navSymbol(int row) const
+{
+  auto it = rowCache.constFind(row);
+  if(it == rowCache.constEnd())
+  {
+    // Get nav type from SQL model
+    QString navtype = sqlModel->getSqlRecord(row).valueStr("nav_type");
+    maptypes::MapObjectTypes type = maptypes::navTypeToMapObjectType(navtype);
+
+    NavSymbol symbol = NONE;
+    if(type == maptypes::WAYPOINT)
+      symbol = WAYPOINT;
+    else if(type == maptypes::NDB)
+      symbol = NDB;
+    else if(type == maptypes::VOR)
+    {
+      if(navtype == "D")
+        symbol = DME;
+      else if(navtype == "VD")
+        symbol = VORDME;
+      else
+        symbol = VOR;
+    }
+    it = rowCache.insert(row, symbol);
+  }
+  return it.value();
+}
+
+const QPixmap *NavIconDelegate::navSymbolPixmap(NavSymbol symbol, int size, qreal pixelRatio) const
+{
+  quint64 key = static_cast<quint64>(symbol) |
+                (static_cast<quint64>(size & 0xffff) << 8) |
+                (static_cast<quint64>(atools::roundToInt(pixelRatio * 100.) & 0xffff) << 24);
+
+  QPixmap *pixmap = symbolCache.object(key);
+  if(pixmap == nullptr)
   {
-    maptypes::MapVor vor;
-    vor.dmeOnly = navtype == "D";
-    vor.hasDme = navtype == "VD" || navtype == "D";
-    symbolPainter->drawVorSymbol(painter, vor, x, y, symbolSize, false, false, 0);
+    int pixmapSize = size * 2;
+    pixmap = new QPixmap(QSize(pixmapSize, pixmapSize) * pixelRatio);
+    pixmap->setDevicePixelRatio(pixelRatio);
+    pixmap->fill(Qt::transparent);
+
+    QPainter painter(pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    if(symbol == WAYPOINT)
+      // An empty waypoint is enough to draw the symbol
+      symbolPainter->drawWaypointSymbol(&painter, QColor(), size, size, size, false, false);
+    else if(symbol == NDB)
+      symbolPainter->drawNdbSymbol(&painter, size, size, size, false, false);
+    else
+    {
+      maptypes::MapVor vor;
+      vor.dmeOnly = symbol == DME;
+      vor.hasDme = symbol == VORDME || symbol == DME;
+      symbolPainter->drawVorSymbol(&painter, vor, size, size, size, false, false, 0);
+    }
+    painter.end();
+
+    symbolCache.insert(key, pixmap);
   }
+  return pixmap;
+}
+
+void NavIconDelegate::clearRowCache()
+{
+  rowCache.clear();
 }
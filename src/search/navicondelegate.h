@@ -18,7 +18,10 @@
 #ifndef LITTLENAVMAP_NAVICONDELEGATE_H
 #define LITTLENAVMAP_NAVICONDELEGATE_H
 
-#include <QStyledItemDelegate>
+#include "search/searchicondelegate.h"
+
+#include <QCache>
+#include <QHash>
 
 class ColumnList;
 class SymbolPainter;
@@ -27,7 +30,7 @@ class SymbolPainter;
  * Paints navaid icons into the "ident" cell of the search result table view.
  */
 class NavIconDelegate :
-  public QStyledItemDelegate
+  public SearchIconDelegate
 {
   Q_OBJECT
 
@@ -36,12 +39,37 @@ public:
   virtual ~NavIconDelegate();
 
 private:
+  /* Symbol type decoded from the nav_type column */
+  enum NavSymbol
+  {
+    NONE,
+    WAYPOINT,
+    NDB,
+    VOR,
+    VORDME,
+    DME
+  };
+
   const ColumnList *cols;
   SymbolPainter *symbolPainter;
 
   virtual void paint(QPainter *painter, const QStyleOptionViewItem& option,
                      const QModelIndex& index) const override;
 
+  /* Get symbol type for the row from cache or decode it from the SQL record */
+  NavSymbol navSymbol(int row) const;
+
+  /* Get rendered symbol from cache or draw it */
+  const QPixmap *navSymbolPixmap(NavSymbol symbol, int size, qreal pixelRatio) const;
+
+  virtual void clearRowCache() override;
+
+  /* Decoded rows of the SQL model. Cleared when the query is reset. */
+  mutable QHash<int, NavSymbol> rowCache;
+
+  /* Rendered symbols. Key contains symbol type, size and pixel ratio. */
+  mutable QCache<quint64, QPixmap> symbolCache;
+
 };
 
 #endif // LITTLENAVMAP_NAVICONDELEGATE_H
@@ -238,7 +238,7 @@ QVariant NavSearch::modelDataHandler(int colIndex, int rowIndex, const Column *c
       return formatModelData(col, displayRoleValue);
 
     case Qt::TextAlignmentRole:
-      if(col->getColumnName() == "ident" || col->getColumnName() == "airport_ident" ||
+      if(columnFormat(col) == FORMAT_IDENT ||
          displayRoleValue.type() == QVariant::Int || displayRoleValue.type() == QVariant::UInt ||
          displayRoleValue.type() == QVariant::LongLong || displayRoleValue.type() == QVariant::ULongLong ||
          displayRoleValue.type() == QVariant::Double)
@@ -259,35 +259,81 @@ QVariant NavSearch::modelDataHandler(int colIndex, int rowIndex, const Column *c
   return QVariant();
 }
 
+/* Get the formatting for a column and remember it */
+NavSearch::ColumnFormat NavSearch::columnFormat(const Column *col) const
+{
+  auto it = columnFormats.constFind(col);
+  if(it != columnFormats.constEnd())
+    return it.value();
+
+  const QString& name = col->getColumnName();
+  ColumnFormat format = FORMAT_DEFAULT;
+  if(name == "type")
+    format = FORMAT_TYPE;
+  else if(name == "nav_type")
+    format = FORMAT_NAV_TYPE;
+  else if(name == "name")
+    format = FORMAT_NAME;
+  else if(name == "range")
+    format = FORMAT_RANGE;
+  else if(name == "altitude")
+    format = FORMAT_ALTITUDE;
+  else if(name == "frequency")
+    format = FORMAT_FREQUENCY;
+  else if(name == "mag_var")
+    format = FORMAT_MAGVAR;
+  else if(name == "ident" || name == "airport_ident")
+    format = FORMAT_IDENT;
+
+  columnFormats.insert(col, format);
+  return format;
+}
+
 /* Formats the QVariant to a QString depending on column name */
 QString NavSearch::formatModelData(const Column *col, const QVariant& displayRoleValue) const
 {
   // Called directly by the model for export functions
-  if(col->getColumnName() == "type")
-    return maptypes::navTypeName(displayRoleValue.toString());
-  else if(col->getColumnName() == "nav_type")
-    return maptypes::navName(displayRoleValue.toString());
-  else if(col->getColumnName() == "name")
-    return atools::capString(displayRoleValue.toString());
-  else if(col->getColumnName() == "range")
-    return Unit::distNm(displayRoleValue.toFloat(), false);
-  else if(col->getColumnName() == "altitude")
-    return Unit::altFeet(displayRoleValue.toFloat(), false);
-  else if(col->getColumnName() == "frequency" && !displayRoleValue.isNull())
+  switch(columnFormat(col))
   {
-    double freq = displayRoleValue.toDouble();
-
-    // VOR and DME are scaled up in nav_search to easily differentiate from NDB
-    if(freq >= 1000000 && freq <= 1200000)
-      return QLocale().toString(displayRoleValue.toDouble() / 10000., 'f', 2);
-    else if(freq >= 10000 && freq <= 120000)
-      return QLocale().toString(displayRoleValue.toDouble() / 100., 'f', 1);
-    else
-      return "Invalid";
+    case FORMAT_TYPE:
+      return maptypes::navTypeName(displayRoleValue.toString());
+
+    case FORMAT_NAV_TYPE:
+      return maptypes::navName(displayRoleValue.toString());
+
+    case FORMAT_NAME:
+      return atools::capString(displayRoleValue.toString());
+
+    case FORMAT_RANGE:
+      return Unit::distNm(displayRoleValue.toFloat(), false);
+
+    case FORMAT_ALTITUDE:
+      return Unit::altFeet(displayRoleValue.toFloat(), false);
+
+    case FORMAT_FREQUENCY:
+      if(!displayRoleValue.isNull())
+      {
+        double freq = displayRoleValue.toDouble();
+
+        // VOR and DME are scaled up in nav_search to easily differentiate from NDB
+        if(freq >= 1000000 && freq <= 1200000)
+          return QLocale().toString(displayRoleValue.toDouble() / 10000., 'f', 2);
+        else if(freq >= 10000 && freq <= 120000)
+          return QLocale().toString(displayRoleValue.toDouble() / 100., 'f', 1);
+        else
+          return "Invalid";
+      }
+      break;
+
+    case FORMAT_MAGVAR:
+      return maptypes::magvarText(displayRoleValue.toFloat());
+
+    case FORMAT_IDENT:
+    case FORMAT_DEFAULT:
+      break;
   }
-  else if(col->getColumnName() == "mag_var")
-    return maptypes::magvarText(displayRoleValue.toFloat());
-  else if(displayRoleValue.type() == QVariant::Int || displayRoleValue.type() == QVariant::UInt)
+
+  if(displayRoleValue.type() == QVariant::Int || displayRoleValue.type() == QVariant::UInt)
     return QLocale().toString(displayRoleValue.toInt());
   else if(displayRoleValue.type() == QVariant::LongLong || displayRoleValue.type() == QVariant::ULongLong)
     return QLocale().toString(displayRoleValue.toLongLong());
@@ -21,6 +21,7 @@
 #include "search/searchbase.h"
 
 #include <QObject>
+#include <QHash>
 
 class QWidget;
 class QTableView;
@@ -67,6 +68,25 @@ private:
                             const QVariant& displayRoleValue, Qt::ItemDataRole role) const;
   QString formatModelData(const Column *col, const QVariant& displayRoleValue) const;
 
+  /* Formatting for a column. Resolved once per column to avoid string comparisons for each table cell. */
+  enum ColumnFormat
+  {
+    FORMAT_DEFAULT,
+    FORMAT_IDENT,
+    FORMAT_TYPE,
+    FORMAT_NAV_TYPE,
+    FORMAT_NAME,
+    FORMAT_RANGE,
+    FORMAT_ALTITUDE,
+    FORMAT_FREQUENCY,
+    FORMAT_MAGVAR
+  };
+
+  ColumnFormat columnFormat(const Column *col) const;
+
+  /* Maps columns to formatting. Columns are owned by the column list and do not change. */
+  mutable QHash<const Column *, ColumnFormat> columnFormats;
+
   /* All layouts, lines and drop down menu items */
   QList<QObject *> navSearchWidgets;
 
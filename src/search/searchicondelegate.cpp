@@ -0,0 +1,76 @@
+/*****************************************************************************
+* Copyright 2015-2017 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "search/searchicondelegate.h"
+
+#include "search/sqlmodel.h"
+#include "search/sqlproxymodel.h"
+
+SearchIconDelegate::SearchIconDelegate()
+{
+
+}
+
+SearchIconDelegate::~SearchIconDelegate()
+{
+
+}
+
+int SearchIconDelegate::sourceRow(const QModelIndex& index) const
+{
+  // Convert index to source if distance search proxy is used
+  return sqlProxyModel != nullptr ? sqlProxyModel->mapToSource(index).row() : index.row();
+}
+
+void SearchIconDelegate::updateModel(const QAbstractItemModel *model) const
+{
+  if(model == viewModel)
+    return;
+
+  SearchIconDelegate *delegate = const_cast<SearchIconDelegate *>(this);
+  if(sqlModel != nullptr)
+    disconnect(sqlModel, nullptr, delegate, nullptr);
+
+  viewModel = model;
+  sqlModel = dynamic_cast<const SqlModel *>(model);
+  sqlProxyModel = nullptr;
+  if(sqlModel == nullptr)
+  {
+    // Distance search uses a proxy
+    sqlProxyModel = dynamic_cast<const SqlProxyModel *>(model);
+    Q_ASSERT(sqlProxyModel != nullptr);
+    sqlModel = dynamic_cast<const SqlModel *>(sqlProxyModel->sourceModel());
+  }
+  Q_ASSERT(sqlModel != nullptr);
+
+  // Rows are only appended when fetching more - everything else resets the query
+  connect(sqlModel, &QAbstractItemModel::modelReset, delegate, &SearchIconDelegate::clearRowCache);
+  connect(sqlModel, &QAbstractItemModel::layoutChanged, delegate, &SearchIconDelegate::clearRowCache);
+  connect(sqlModel, &QAbstractItemModel::rowsRemoved, delegate, &SearchIconDelegate::clearRowCache);
+  connect(sqlModel, &QObject::destroyed, delegate, &SearchIconDelegate::modelDestroyed);
+
+  delegate->clearRowCache();
+}
+
+void SearchIconDelegate::modelDestroyed()
+{
+  // Force lookup of new model on next paint
+  viewModel = nullptr;
+  sqlModel = nullptr;
+  sqlProxyModel = nullptr;
+  clearRowCache();
+}
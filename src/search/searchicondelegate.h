@@ -0,0 +1,61 @@
+/*****************************************************************************
+* Copyright 2015-2017 Alexander Barthel albar965@mailbox.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_SEARCHICONDELEGATE_H
+#define LITTLENAVMAP_SEARCHICONDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+class SqlModel;
+class SqlProxyModel;
+class QAbstractItemModel;
+
+/*
+ * Base for delegates painting icons into the search result table view. Tracks the SQL model behind the view
+ * and notifies derived classes when their cache of decoded rows gets invalid.
+ */
+class SearchIconDelegate :
+  public QStyledItemDelegate
+{
+  Q_OBJECT
+
+public:
+  SearchIconDelegate();
+  virtual ~SearchIconDelegate();
+
+protected:
+  /* Resolve the SQL model and proxy for the view model and clear the row cache if the model changes */
+  void updateModel(const QAbstractItemModel *model) const;
+
+  /* Get the row in the SQL model for the view index. Call updateModel before. */
+  int sourceRow(const QModelIndex& index) const;
+
+  /* Called when the query is reset or the model is replaced */
+  virtual void clearRowCache() = 0;
+
+  mutable const SqlModel *sqlModel = nullptr;
+
+private:
+  /* Called when the SQL model is deleted */
+  void modelDestroyed();
+
+  mutable const QAbstractItemModel *viewModel = nullptr;
+  mutable const SqlProxyModel *sqlProxyModel = nullptr;
+
+};
+
+#endif // LITTLENAVMAP_SEARCHICONDELEGATE_H